@@ -33,6 +33,7 @@
 #include "postmaster/autovacuum.h"
 #include "storage/bufmgr.h"
 #include "storage/freespace.h"
+#include "storage/lmgr.h"
 #include "tcop/tcopprot.h"
 #include "utils/acl.h"
 #include "utils/datum.h"
@@ -216,6 +217,8 @@ static BrinInsertState *initialize_brin_insertstate(Relation idxRel, IndexInfo *
 static void terminate_brin_buildstate(BrinBuildState *state);
 static void brinsummarize(Relation index, Relation heapRel, BlockNumber pageRange,
 						  bool include_partial, double *numSummarized, double *numExisting);
+static bool brininsert_summarize(Relation idxRel, Relation heapRel,
+								 BlockNumber pageRange);
 static void form_and_insert_tuple(BrinBuildState *state);
 static void form_and_spill_tuple(BrinBuildState *state);
 static void union_tuples(BrinDesc *bdesc, BrinMemTuple *a,
@@ -409,6 +412,15 @@ brininsert(Relation idxRel, Datum *values, bool *nulls,
 				recorded = AutoVacuumRequestWork(AVW_BRINSummarizeRange,
 												 RelationGetRelid(idxRel),
 												 lastPageRange);
+
+				/*
+				 * If autovacuum's work item queue is full, summarize the
+				 * range ourselves rather than leaving it unsummarized until
+				 * the next VACUUM.
+				 */
+				if (!recorded)
+					recorded = brininsert_summarize(idxRel, heapRel,
+													lastPageRange);
 				if (!recorded)
 					ereport(LOG,
 							(errcode(ERRCODE_PROGRAM_LIMIT_EXCEEDED),
@@ -506,6 +518,41 @@ brininsert(Relation idxRel, Datum *values, bool *nulls,
 	return false;
 }
 
+/*
+ * Summarize the page range containing pageRange from within brininsert, when
+ * the request to have autovacuum do it could not be recorded.
+ *
+ * Summarization normally runs under ShareUpdateExclusiveLock on the table
+ * and the index, which keeps concurrent summarizers and VACUUM away.  We
+ * only try to get those locks conditionally, since an inserting backend
+ * mustn't wait for VACUUM or risk deadlocking against other inserters.
+ * Returns false if we couldn't get them.
+ */
+static bool
+brininsert_summarize(Relation idxRel, Relation heapRel, BlockNumber pageRange)
+{
+	double		numSummarized = 0;
+
+	/* see gin_clean_pending_list() */
+	if (!idxRel->rd_index->indisvalid)
+		return false;
+
+	if (!ConditionalLockRelation(heapRel, ShareUpdateExclusiveLock))
+		return false;
+	if (!ConditionalLockRelation(idxRel, ShareUpdateExclusiveLock))
+	{
+		UnlockRelation(heapRel, ShareUpdateExclusiveLock);
+		return false;
+	}
+
+	brinsummarize(idxRel, heapRel, pageRange, false, &numSummarized, NULL);
+
+	UnlockRelation(idxRel, ShareUpdateExclusiveLock);
+	UnlockRelation(heapRel, ShareUpdateExclusiveLock);
+
+	return true;
+}
+
 /*
  * Callback to clean up the BrinInsertState once all tuple inserts are done.
  */
@@ -26,6 +26,8 @@ static struct varlena *toast_fetch_datum(struct varlena *attr);
 static struct varlena *toast_fetch_datum_slice(struct varlena *attr,
 											   int32 sliceoffset,
 											   int32 slicelength);
+static struct varlena *toast_fetch_zstd_prefix(struct varlena *attr,
+											   int32 slicelimit);
 static struct varlena *toast_decompress_datum(struct varlena *attr);
 static struct varlena *toast_decompress_datum_slice(struct varlena *attr, int32 slicelength);
 
@@ -237,8 +239,16 @@ detoast_attr_slice(struct varlena *attr,
 		 * For compressed values, we need to fetch enough slices to decompress
 		 * at least the requested part (when a prefix is requested).
 		 * Otherwise, just fetch all slices.
+		 *
+		 * zstd data can be decompressed incrementally, so for that we fetch
+		 * and decompress growing prefixes until the slice is covered.
 		 */
-		if (slicelimit >= 0)
+		if (slicelimit >= 0 &&
+			VARATT_EXTERNAL_GET_COMPRESS_METHOD(toast_pointer) ==
+			TOAST_ZSTD_COMPRESSION_ID &&
+			slicelimit < toast_pointer.va_rawsize - VARHDRSZ)
+			preslice = toast_fetch_zstd_prefix(attr, slicelimit);
+		else if (slicelimit >= 0)
 		{
 			int32		max_size = VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer);
 
@@ -462,6 +472,53 @@ toast_fetch_datum_slice(struct varlena *attr, int32 sliceoffset,
 	return result;
 }
 
+/* ----------
+ * toast_fetch_zstd_prefix -
+ *
+ *	Fetch and decompress the first slicelimit bytes of an external datum
+ *	compressed with zstd.
+ *
+ *	There's no way to know up front how much compressed data a prefix needs,
+ *	so we guess from the datum's overall compression ratio, and keep doubling
+ *	the amount fetched until the decompressed prefix is long enough.  That
+ *	reads at most about twice the chunks actually needed, rather than all of
+ *	them.  The result is not compressed.
+ * ----------
+ */
+static struct varlena *
+toast_fetch_zstd_prefix(struct varlena *attr, int32 slicelimit)
+{
+	struct varatt_external toast_pointer;
+	int32		extsize;
+	int32		rawsize;
+	int64		guess;
+	int32		fetchsize;
+
+	VARATT_EXTERNAL_GET_POINTER(toast_pointer, attr);
+	extsize = VARATT_EXTERNAL_GET_EXTSIZE(toast_pointer);
+	rawsize = toast_pointer.va_rawsize - VARHDRSZ;
+
+	/* first guess, with some slack since data rarely compresses uniformly */
+	guess = (int64) extsize * slicelimit / Max(rawsize, 1) * 2 + BLCKSZ;
+	fetchsize = (int32) Min(guess, extsize);
+
+	for (;;)
+	{
+		struct varlena *compressed;
+		struct varlena *result;
+
+		compressed = toast_fetch_datum_slice(attr, 0, fetchsize);
+		result = zstd_decompress_datum_slice(compressed, slicelimit);
+		pfree(compressed);
+
+		if (VARSIZE(result) - VARHDRSZ >= slicelimit || fetchsize >= extsize)
+			return result;
+
+		pfree(result);
+		fetchsize = (fetchsize > extsize / 2) ? extsize : fetchsize * 2;
+	}
+}
+
 /* ----------
  * toast_decompress_datum -
  *
@@ -485,6 +542,8 @@ toast_decompress_datum(struct varlena *attr)
 			return pglz_decompress_datum(attr);
 		case TOAST_LZ4_COMPRESSION_ID:
 			return lz4_decompress_datum(attr);
+		case TOAST_ZSTD_COMPRESSION_ID:
+			return zstd_decompress_datum(attr);
 		default:
 			elog(ERROR, "invalid compression method id %d", cmid);
 			return NULL;		/* keep compiler quiet */
@@ -528,6 +587,8 @@ toast_decompress_datum_slice(struct varlena *attr, int32 slicelength)
 			return pglz_decompress_datum_slice(attr, slicelength);
 		case TOAST_LZ4_COMPRESSION_ID:
 			return lz4_decompress_datum_slice(attr, slicelength);
+		case TOAST_ZSTD_COMPRESSION_ID:
+			return zstd_decompress_datum_slice(attr, slicelength);
 		default:
 			elog(ERROR, "invalid compression method id %d", cmid);
 			return NULL;		/* keep compiler quiet */
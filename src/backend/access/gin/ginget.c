@@ -647,6 +647,55 @@ startScan(IndexScanDesc scan)
 		startScanKey(ginstate, so, so->keys + i);
 }
 
+/*
+ * Find the first item in entry->list, at or after position 'start', that is
+ * greater than advancePast.  Returns entry->nlist if there is none.
+ *
+ * When another key lets us skip far ahead in this entry, a linear scan over
+ * the skipped items is wasted effort, so we gallop forward in exponentially
+ * growing steps and then binary search within the last step.
+ */
+static int
+entrySkipPastItem(GinScanEntry entry, int start, ItemPointerData advancePast)
+{
+	int			lo;
+	int			hi;
+	int			step = 1;
+
+	if (start >= entry->nlist ||
+		ginCompareItemPointers(&entry->list[start], &advancePast) > 0)
+		return start;
+
+	/* entry->list[lo] <= advancePast; find hi with entry->list[hi] > it */
+	lo = start;
+	for (;;)
+	{
+		hi = lo + step;
+		if (hi >= entry->nlist)
+		{
+			hi = entry->nlist;
+			break;
+		}
+		if (ginCompareItemPointers(&entry->list[hi], &advancePast) > 0)
+			break;
+		lo = hi;
+		step *= 2;
+	}
+
+	/* binary search in (lo, hi] */
+	while (hi - lo > 1)
+	{
+		int			mid = lo + (hi - lo) / 2;
+
+		if (ginCompareItemPointers(&entry->list[mid], &advancePast) <= 0)
+			lo = mid;
+		else
+			hi = mid;
+	}
+
+	return hi;
+}
+
 /*
  * Load the next batch of item pointers from a posting tree.
  *
@@ -772,22 +821,20 @@ entryLoadMoreItems(GinState *ginstate, GinScanEntry entry,
 
 		entry->list = GinDataLeafPageGetItems(page, &entry->nlist, advancePast);
 
-		for (i = 0; i < entry->nlist; i++)
+		i = entrySkipPastItem(entry, 0, advancePast);
+		if (i < entry->nlist)
 		{
-			if (ginCompareItemPointers(&advancePast, &entry->list[i]) < 0)
-			{
-				entry->offset = i;
+			entry->offset = i;
 
-				if (GinPageRightMost(page))
-				{
-					/* after processing the copied items, we're done. */
-					UnlockReleaseBuffer(entry->buffer);
-					entry->buffer = InvalidBuffer;
-				}
-				else
-					LockBuffer(entry->buffer, GIN_UNLOCK);
-				return;
+			if (GinPageRightMost(page))
+			{
+				/* after processing the copied items, we're done. */
+				UnlockReleaseBuffer(entry->buffer);
+				entry->buffer = InvalidBuffer;
 			}
+			else
+				LockBuffer(entry->buffer, GIN_UNLOCK);
+			return;
 		}
 	}
 }
@@ -924,6 +971,8 @@ entryGetItem(GinState *ginstate, GinScanEntry entry,
 		 * A posting list from an entry tuple, or the last page of a posting
 		 * tree.
 		 */
+		entry->offset = entrySkipPastItem(entry, entry->offset, advancePast);
+
 		for (;;)
 		{
 			if (entry->offset >= entry->nlist)
@@ -949,6 +998,21 @@ entryGetItem(GinState *ginstate, GinScanEntry entry,
 		/* A posting tree */
 		for (;;)
 		{
+			int			next;
+
+			/*
+			 * Skip over items <= advancePast in the current batch.  Remember
+			 * the last skipped item as curItem, as if we had stepped over
+			 * them one by one, so that entryLoadMoreItems can still tell
+			 * when it's enough to step right.
+			 */
+			next = entrySkipPastItem(entry, entry->offset, advancePast);
+			if (next > entry->offset)
+			{
+				entry->curItem = entry->list[next - 1];
+				entry->offset = next;
+			}
+
 			/* If we've processed the current batch, load more items */
 			while (entry->offset >= entry->nlist)
 			{
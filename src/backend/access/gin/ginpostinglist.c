@@ -313,10 +313,14 @@ ginPostingListDecodeAllSegments(GinPostingList *segment, int len, int *ndecoded_
 	ndecoded = 0;
 	while ((char *) segment < endseg)
 	{
-		/* enlarge output array if needed */
-		if (ndecoded >= nallocated)
+		/*
+		 * Every item after the first one takes at least one byte, so this
+		 * segment holds at most nbytes + 1 items.  Make room for all of them
+		 * up front, so that the decoding loop below needn't check.
+		 */
+		if (ndecoded + segment->nbytes + 1 > nallocated)
 		{
-			nallocated *= 2;
+			nallocated = Max(nallocated * 2, ndecoded + segment->nbytes + 1);
 			result = repalloc(result, nallocated * sizeof(ItemPointerData));
 		}
 
@@ -331,11 +335,28 @@ ginPostingListDecodeAllSegments(GinPostingList *segment, int len, int *ndecoded_
 		endptr = segment->bytes + segment->nbytes;
 		while (ptr < endptr)
 		{
-			/* enlarge output array if needed */
-			if (ndecoded >= nallocated)
+			/*
+			 * In dense posting lists most deltas fit in a single byte.  If
+			 * none of the next 8 bytes has its continuation bit set, they
+			 * are 8 complete integers, and we can decode them without
+			 * testing each byte separately.
+			 */
+			if (endptr - ptr >= sizeof(uint64))
 			{
-				nallocated *= 2;
-				result = repalloc(result, nallocated * sizeof(ItemPointerData));
+				uint64		chunk;
+
+				memcpy(&chunk, ptr, sizeof(uint64));
+				if ((chunk & UINT64CONST(0x8080808080808080)) == 0)
+				{
+					for (int i = 0; i < sizeof(uint64); i++)
+					{
+						val += ptr[i];
+						uint64_to_itemptr(val, &result[ndecoded]);
+						ndecoded++;
+					}
+					ptr += sizeof(uint64);
+					continue;
+				}
 			}
 
 			val += decode_varbyte(&ptr);
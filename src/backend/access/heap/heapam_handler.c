@@ -2577,28 +2577,49 @@ BitmapHeapScanNextBlock(TableScanDesc scan,
 		OffsetNumber maxoff = PageGetMaxOffsetNumber(page);
 		OffsetNumber offnum;
 
-		for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum))
+		/*
+		 * If the page is all-visible, every normal tuple on it is visible to
+		 * an MVCC snapshot, so we can skip the per-tuple visibility checks,
+		 * like heap_prepare_pagescan() does.  Serializable transactions still
+		 * need to predicate-lock and check each tuple, so they take the slow
+		 * path.
+		 */
+		if (IsMVCCSnapshot(snapshot) &&
+			PageIsAllVisible(page) &&
+			!snapshot->takenDuringRecovery &&
+			!CheckForSerializableConflictOutNeeded(scan->rs_rd, snapshot))
 		{
-			ItemId		lp;
-			HeapTupleData loctup;
-			bool		valid;
-
-			lp = PageGetItemId(page, offnum);
-			if (!ItemIdIsNormal(lp))
-				continue;
-			loctup.t_data = (HeapTupleHeader) PageGetItem(page, lp);
-			loctup.t_len = ItemIdGetLength(lp);
-			loctup.t_tableOid = scan->rs_rd->rd_id;
-			ItemPointerSet(&loctup.t_self, block, offnum);
-			valid = HeapTupleSatisfiesVisibility(&loctup, snapshot, buffer);
-			if (valid)
+			for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum))
 			{
-				hscan->rs_vistuples[ntup++] = offnum;
-				PredicateLockTID(scan->rs_rd, &loctup.t_self, snapshot,
-								 HeapTupleHeaderGetXmin(loctup.t_data));
+				if (ItemIdIsNormal(PageGetItemId(page, offnum)))
+					hscan->rs_vistuples[ntup++] = offnum;
+			}
+		}
+		else
+		{
+			for (offnum = FirstOffsetNumber; offnum <= maxoff; offnum = OffsetNumberNext(offnum))
+			{
+				ItemId		lp;
+				HeapTupleData loctup;
+				bool		valid;
+
+				lp = PageGetItemId(page, offnum);
+				if (!ItemIdIsNormal(lp))
+					continue;
+				loctup.t_data = (HeapTupleHeader) PageGetItem(page, lp);
+				loctup.t_len = ItemIdGetLength(lp);
+				loctup.t_tableOid = scan->rs_rd->rd_id;
+				ItemPointerSet(&loctup.t_self, block, offnum);
+				valid = HeapTupleSatisfiesVisibility(&loctup, snapshot, buffer);
+				if (valid)
+				{
+					hscan->rs_vistuples[ntup++] = offnum;
+					PredicateLockTID(scan->rs_rd, &loctup.t_self, snapshot,
+									 HeapTupleHeaderGetXmin(loctup.t_data));
+				}
+				HeapCheckForSerializableConflictOut(valid, scan->rs_rd, &loctup,
+													buffer, snapshot);
 			}
-			HeapCheckForSerializableConflictOut(valid, scan->rs_rd, &loctup,
-												buffer, snapshot);
 		}
 	}
 
@@ -23,6 +23,7 @@
 #include "storage/predicate.h"
 #include "utils/datum.h"
 #include "utils/rel.h"
+#include "utils/spccache.h"
 
 
 /*
@@ -524,6 +525,27 @@ _bt_readpage(IndexScanDesc scan, ScanDirection dir, OffsetNumber offnum,
 	 */
 	Assert(!pstate.forcenonrequired);
 
+	/*
+	 * Once a primitive index scan has moved past its first leaf page, it's
+	 * probably a range scan that will go on to read the next sibling page
+	 * too.  Start reading that page now, so that the I/O overlaps with the
+	 * processing of the items we just saved.  We don't do this on the first
+	 * page, since most scans that only need one leaf page stop there.
+	 */
+	if (!firstpage &&
+		get_tablespace_io_concurrency(rel->rd_rel->reltablespace) > 0)
+	{
+		BlockNumber sibling = P_NONE;
+
+		if (ScanDirectionIsForward(dir) && so->currPos.moreRight)
+			sibling = so->currPos.nextPage;
+		else if (ScanDirectionIsBackward(dir) && so->currPos.moreLeft)
+			sibling = so->currPos.prevPage;
+
+		if (sibling != P_NONE)
+			PrefetchBuffer(rel, MAIN_FORKNUM, sibling);
+	}
+
 	return (so->currPos.firstItem <= so->currPos.lastItem);
 }
 
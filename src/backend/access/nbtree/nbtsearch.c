@@ -18,19 +18,28 @@
 #include "access/nbtree.h"
 #include "access/relscan.h"
 #include "access/xact.h"
+#include "common/int.h"
 #include "executor/instrument_node.h"
 #include "miscadmin.h"
 #include "pgstat.h"
 #include "storage/predicate.h"
+#include "utils/fmgrprotos.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 
 
+/* Minimum window size, and maximum galloping step, for interpolation */
+#define BT_INTERPOLATE_MIN_ITEMS	32
+#define BT_INTERPOLATE_MAX_STEP		8
+
 static inline void _bt_drop_lock_and_maybe_pin(Relation rel, BTScanOpaque so);
 static Buffer _bt_moveright(Relation rel, Relation heaprel, BTScanInsert key,
 							Buffer buf, bool forupdate, BTStack stack,
 							int access);
 static OffsetNumber _bt_binsrch(Relation rel, BTScanInsert key, Buffer buf);
+static void _bt_interpolate_window(Relation rel, BTScanInsert key, Page page,
+								   int32 cmpval, OffsetNumber *low,
+								   OffsetNumber *high);
 static int	_bt_binsrch_posting(BTScanInsert key, Page page,
 								OffsetNumber offnum);
 static inline void _bt_returnitem(IndexScanDesc scan, BTScanOpaque so);
@@ -384,6 +393,10 @@ _bt_binsrch(Relation rel,
 
 	cmpval = key->nextkey ? 0 : 1;	/* select comparison value */
 
+	/* For integer keys, try to guess the right slot first */
+	if (high - low >= BT_INTERPOLATE_MIN_ITEMS)
+		_bt_interpolate_window(rel, key, page, cmpval, &low, &high);
+
 	while (high > low)
 	{
 		OffsetNumber mid = low + ((high - low) / 2);
@@ -444,6 +457,133 @@ _bt_binsrch(Relation rel,
 	return OffsetNumberPrev(low);
 }
 
+/*
+ * Get the first key attribute of the item at offnum as an int64, for
+ * interpolation.  Returns false if it is NULL or truncated away.
+ */
+static inline bool
+_bt_interpolate_getkey(Relation rel, Page page, OffsetNumber offnum,
+					   bool is_int4, int64 *value)
+{
+	IndexTuple	itup;
+	Datum		datum;
+	bool		isnull;
+
+	itup = (IndexTuple) PageGetItem(page, PageGetItemId(page, offnum));
+	if (BTreeTupleGetNAtts(itup, rel) < 1)
+		return false;
+	datum = index_getattr(itup, 1, RelationGetDescr(rel), &isnull);
+	if (isnull)
+		return false;
+	*value = is_int4 ? DatumGetInt32(datum) : DatumGetInt64(datum);
+	return true;
+}
+
+/*
+ *	_bt_interpolate_window() -- Narrow _bt_binsrch's window by interpolation.
+ *
+ * Indexes on sequence-generated or timestamp keys tend to have nearly
+ * uniformly spaced keys on each page.  When the first key column is an
+ * ascending int4, int8 or timestamp(tz) column, we predict the slot of the
+ * scan key by linear interpolation between the first and last keys of the
+ * window, and then probe outward from the prediction in exponentially
+ * growing steps, for a few steps at most.  When the prediction is good,
+ * that leaves _bt_binsrch a window of a few items.  When it isn't, we've
+ * spent a handful of cheap comparisons and _bt_binsrch carries on from
+ * whatever bounds we established.
+ *
+ * *low and *high are updated following _bt_binsrch's loop invariant, so any
+ * probe we make keeps the final result exact.
+ */
+static void
+_bt_interpolate_window(Relation rel, BTScanInsert key, Page page,
+					   int32 cmpval, OffsetNumber *low, OffsetNumber *high)
+{
+	ScanKey		scankey = key->scankeys;
+	PGFunction	cmpfn = scankey->sk_func.fn_addr;
+	bool		is_int4;
+	int64		target,
+				firstval,
+				lastval;
+	int			first,
+				last,
+				guess;
+	int32		result;
+
+	if (cmpfn == btint4cmp)
+		is_int4 = true;
+	else if (cmpfn == btint8cmp || cmpfn == timestamp_cmp)
+		is_int4 = false;
+	else
+		return;
+
+	if (scankey->sk_flags & (SK_ISNULL | SK_BT_DESC))
+		return;
+	target = is_int4 ? DatumGetInt32(scankey->sk_argument) :
+		DatumGetInt64(scankey->sk_argument);
+
+	/* The first data item of an internal page is a "minus infinity" item */
+	first = *low;
+	if (!P_ISLEAF(BTPageGetOpaque(page)))
+		first++;
+	last = *high - 1;
+	if (last - first < 2 ||
+		!_bt_interpolate_getkey(rel, page, first, is_int4, &firstval) ||
+		!_bt_interpolate_getkey(rel, page, last, is_int4, &lastval) ||
+		lastval <= firstval)
+		return;
+
+	if (target <= firstval)
+		guess = first;
+	else if (target >= lastval)
+		guess = last;
+	else
+		guess = first + (int) (((double) target - (double) firstval) /
+							   ((double) lastval - (double) firstval) *
+							   (last - first));
+	Assert(guess >= *low && guess < *high);
+
+	result = _bt_compare(rel, key, page, guess);
+	if (result >= cmpval)
+	{
+		*low = guess + 1;
+
+		/* Gallop right until we find an item that's past the scan key */
+		for (int step = 1; step <= BT_INTERPOLATE_MAX_STEP && *low < *high;
+			 step *= 2)
+		{
+			int			probe = Min(*low + step - 1, *high - 1);
+
+			if (_bt_compare(rel, key, page, probe) >= cmpval)
+				*low = probe + 1;
+			else
+			{
+				*high = probe;
+				break;
+			}
+		}
+	}
+	else
+	{
+		*high = guess;
+
+		/* Gallop left until we find an item that's before the scan key */
+		for (int step = 1; step <= BT_INTERPOLATE_MAX_STEP && *low < *high;
+			 step *= 2)
+		{
+			int			probe = Max(*high - step, *low);
+
+			if (_bt_compare(rel, key, page, probe) >= cmpval)
+			{
+				*low = probe + 1;
+				break;
+			}
+			else
+				*high = probe;
+		}
+	}
+}
+
 /*
  *
  *	_bt_binsrch_insert() -- Cacheable, incremental leaf page binary search.
@@ -653,6 +793,35 @@ _bt_binsrch_posting(BTScanInsert key, Page page, OffsetNumber offnum)
 	return low;
 }
 
+/*
+ * Call the scankey's ORDER proc to compare an index datum to sk_argument.
+ *
+ * The comparators for the most common integer-like key types are inlined here,
+ * saving a trip through the function manager for each binary search probe.
+ * This is the same idea as sortsupport's fast comparators, but keyed on the
+ * proc's C function, so that no extra state is needed in the scankey.
+ */
+static inline int32
+_bt_compare_datum(ScanKey scankey, Datum datum)
+{
+	PGFunction	cmpfn = scankey->sk_func.fn_addr;
+
+	if (cmpfn == btint4cmp)
+		return pg_cmp_s32(DatumGetInt32(datum),
+						  DatumGetInt32(scankey->sk_argument));
+	if (cmpfn == btint8cmp || cmpfn == timestamp_cmp)
+		return pg_cmp_s64(DatumGetInt64(datum),
+						  DatumGetInt64(scankey->sk_argument));
+	if (cmpfn == btoidcmp)
+		return pg_cmp_u32(DatumGetObjectId(datum),
+						  DatumGetObjectId(scankey->sk_argument));
+
+	return DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
+										   scankey->sk_collation,
+										   datum,
+										   scankey->sk_argument));
+}
+
 /*----------
  *	_bt_compare() -- Compare insertion-type scankey to tuple on a page.
  *
@@ -758,10 +927,7 @@ _bt_compare(Relation rel,
 			 * to flip the sign of the comparison result.  (Unless it's a DESC
 			 * column, in which case we *don't* flip the sign.)
 			 */
-			result = DatumGetInt32(FunctionCall2Coll(&scankey->sk_func,
-													 scankey->sk_collation,
-													 datum,
-													 scankey->sk_argument));
+			result = _bt_compare_datum(scankey, datum);
 
 			if (!(scankey->sk_flags & SK_BT_DESC))
 				INVERT_COMPARE_RESULT(result);
@@ -38,6 +38,7 @@
 #include "replication/slot.h"
 #include "replication/walsender.h"
 #include "replication/walsender_private.h"
+#include "storage/bufmgr.h"
 #include "storage/bufpage.h"
 #include "storage/checksum.h"
 #include "storage/dsm_impl.h"
@@ -118,6 +119,8 @@ static void parse_basebackup_options(List *options, basebackup_options *opt);
 static int	compareWalFileNames(const ListCell *a, const ListCell *b);
 static ssize_t basebackup_read_file(int fd, char *buf, size_t nbytes, off_t offset,
 									const char *filename, bool partial_read_ok);
+static void basebackup_prefetch_file(int fd, pgoff_t offset, pgoff_t size,
+									 pgoff_t *prefetched);
 
 /* Was the backup currently in-progress initiated in recovery mode? */
 static bool backup_started_in_recovery = false;
@@ -527,6 +530,7 @@ perform_base_backup(basebackup_options *opt, bbsink *sink,
 			int			fd;
 			ssize_t		cnt;
 			pgoff_t		len = 0;
+			pgoff_t		prefetched = 0;
 
 			snprintf(pathbuf, MAXPGPATH, XLOGDIR "/%s", walFileName);
 			XLogFromFileName(walFileName, &tli, &segno, wal_segment_size);
@@ -565,6 +569,7 @@ perform_base_backup(basebackup_options *opt, bbsink *sink,
 			/* send the WAL file itself */
 			_tarWriteHeader(sink, pathbuf, NULL, &statbuf, false);
 
+			basebackup_prefetch_file(fd, 0, wal_segment_size, &prefetched);
 			while ((cnt = basebackup_read_file(fd, sink->bbs_buffer,
 											   Min(sink->bbs_buffer_length,
 												   wal_segment_size - len),
@@ -577,6 +582,8 @@ perform_base_backup(basebackup_options *opt, bbsink *sink,
 
 				if (len == wal_segment_size)
 					break;
+
+				basebackup_prefetch_file(fd, len, wal_segment_size, &prefetched);
 			}
 
 			if (len != wal_segment_size)
@@ -1582,6 +1589,7 @@ sendFile(bbsink *sink, const char *readfilename, const char *tarfilename,
 	int			checksum_failures = 0;
 	off_t		cnt;
 	pgoff_t		bytes_done = 0;
+	pgoff_t		prefetched = 0;
 	bool		verify_checksum = false;
 	pg_checksum_context checksum_ctx;
 	int			ibindex = 0;
@@ -1696,6 +1704,10 @@ sendFile(bbsink *sink, const char *readfilename, const char *tarfilename,
 			if (bytes_done >= statbuf->st_size)
 				break;
 
+			/* Ask the kernel to start reading the data that follows. */
+			basebackup_prefetch_file(fd, bytes_done, statbuf->st_size,
+									 &prefetched);
+
 			/*
 			 * Read as many bytes as will fit in the buffer, or however many
 			 * are left to read, whichever is less.
@@ -2134,3 +2146,44 @@ basebackup_read_file(int fd, char *buf, size_t nbytes, off_t offset,
 
 	return rc;
 }
+
+/*
+ * Issue read-ahead advice for the part of a file that we're about to read.
+ *
+ * Files are read one buffer at a time, so without help from the kernel's
+ * read-ahead we'd only ever have a single read in flight, which is not
+ * nearly enough to saturate storage with high latency or a lot of
+ * parallelism.  We keep up to maintenance_io_concurrency buffers' worth of
+ * data ahead of 'offset' prefetched, so that the reads are already under way
+ * by the time we get to them.
+ *
+ * 'size' is the number of bytes we'll read from the file in total, and
+ * '*prefetched' tracks how far we've already prefetched; the caller should
+ * initialize it to zero.  To avoid a system call for every buffer, the
+ * prefetch window is only topped up once half of it has been consumed.
+ */
+static void
+basebackup_prefetch_file(int fd, pgoff_t offset, pgoff_t size,
+						 pgoff_t *prefetched)
+{
+#if defined(USE_POSIX_FADVISE) && defined(POSIX_FADV_WILLNEED)
+	pgoff_t		distance;
+	pgoff_t		target;
+
+	if (maintenance_io_concurrency <= 0)
+		return;
+
+	distance = (pgoff_t) maintenance_io_concurrency * SINK_BUFFER_LENGTH;
+	target = Min(offset + distance, size);
+
+	if (*prefetched < offset)
+		*prefetched = offset;
+	if (*prefetched >= size || *prefetched - offset >= distance / 2)
+		return;
+
+	/* This is only a hint, so ignore any error. */
+	(void) posix_fadvise(fd, *prefetched, target - *prefetched,
+						 POSIX_FADV_WILLNEED);
+	*prefetched = target;
+#endif
+}
@@ -70,6 +70,7 @@ DiscardAll(bool isTopLevel)
 	SetPGVariable("session_authorization", NIL, false);
 	ResetAllOptions();
 	DropAllPreparedStatements();
+	DropAllSimpleQueryPlans();
 	Async_UnlistenAll();
 	LockReleaseAll(USER_LOCKMETHOD, true);
 	ResetPlanCache();
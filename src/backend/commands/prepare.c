@@ -4,7 +4,8 @@
  *	  Prepareable SQL statements via PREPARE, EXECUTE and DEALLOCATE
  *
  * This module also implements storage of prepared statements that are
- * accessed via the extended FE/BE query protocol.
+ * accessed via the extended FE/BE query protocol, and of the plans cached
+ * for statements sent via the simple query protocol.
  *
  *
  * Copyright (c) 2002-2026, PostgreSQL Global Development Group
@@ -20,20 +21,26 @@
 
 #include "access/xact.h"
 #include "catalog/pg_type.h"
+#include "common/hashfn.h"
 #include "commands/createas.h"
 #include "commands/explain.h"
 #include "commands/explain_format.h"
 #include "commands/explain_state.h"
 #include "commands/prepare.h"
 #include "funcapi.h"
+#include "lib/ilist.h"
 #include "nodes/nodeFuncs.h"
+#include "nodes/queryjumble.h"
+#include "parser/analyze.h"
 #include "parser/parse_coerce.h"
 #include "parser/parse_collate.h"
 #include "parser/parse_expr.h"
 #include "parser/parse_type.h"
 #include "tcop/pquery.h"
+#include "tcop/tcopprot.h"
 #include "tcop/utility.h"
 #include "utils/builtins.h"
+#include "utils/guc_hooks.h"
 #include "utils/snapmgr.h"
 #include "utils/timestamp.h"
 
@@ -46,7 +53,41 @@
  */
 static HTAB *prepared_queries = NULL;
 
+/*
+ * Plans cached for statements received via the simple query protocol, if
+ * plan_cache_simple_queries is set.  The keys for this hash table are the
+ * query IDs of the statements, combined with the number of constants that
+ * were turned into parameters, or hashes of the query strings if query IDs
+ * are not being computed.  The entries hold the plancache entries, which
+ * carry what is needed to verify a match.  A list in least recently used
+ * order is kept to decide which entry to evict when the cache is full.
+ */
+typedef struct SimpleQueryEntry
+{
+	uint64		hashkey;		/* hash key; must be first */
+	CachedPlanSource *plansource;	/* the actual cached plan */
+	dlist_node	lru_node;		/* link in simple_query_lru */
+} SimpleQueryEntry;
+
+/* Working state for normalize_simple_query_mutator */
+typedef struct
+{
+	List	   *consts;			/* distinct constants replaced so far */
+} NormalizeSimpleQueryContext;
+
+static HTAB *simple_queries = NULL;
+static dlist_head simple_query_lru = DLIST_STATIC_INIT(simple_query_lru);
+
+/* GUC parameter */
+int			plan_cache_simple_queries = 0;
+
 static void InitQueryHashTable(void);
+static Node *normalize_simple_query_mutator(Node *node,
+											NormalizeSimpleQueryContext *context);
+static CachedPlanSource *FetchSimpleQueryPlan(uint64 hashkey, Query *query);
+static void StoreSimpleQueryPlan(uint64 hashkey,
+								 CachedPlanSource *plansource);
+static void DropSimpleQueryEntry(SimpleQueryEntry *entry);
 static ParamListInfo EvaluateParams(ParseState *pstate,
 									PreparedStatement *pstmt, List *params,
 									EState *estate);
@@ -558,6 +599,337 @@ DropAllPreparedStatements(void)
 	}
 }
 
+/*
+ * Can the plan of this simple-query statement be cached?
+ *
+ * Only plannable statements qualify; utility statements are executed afresh
+ * each time anyway.  SELECT INTO is a utility statement in disguise.
+ */
+bool
+SimpleQueryIsCacheable(RawStmt *parsetree)
+{
+	switch (nodeTag(parsetree->stmt))
+	{
+		case T_SelectStmt:
+			return ((SelectStmt *) parsetree->stmt)->intoClause == NULL;
+		case T_InsertStmt:
+		case T_UpdateStmt:
+		case T_DeleteStmt:
+		case T_MergeStmt:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/*
+ * Get the plancache entry to use for a simple-query statement, making one
+ * if there is none yet.
+ *
+ * When query IDs are being computed, statements that differ only in their
+ * constants share an entry, in the style of the query jumbling done for
+ * pg_stat_statements.  The statement is run through parse analysis, and the
+ * constants written in it are replaced by parameters, whose values are
+ * returned in *params.  Doing this after parse analysis means that the
+ * constants used as column positions in ORDER BY or GROUP BY, which have
+ * been resolved into references to the target list by then, are left
+ * alone, and that the types of the parameters are those the constants were
+ * resolved to.  Equal constants are replaced by the same parameter, so
+ * that expressions which parse analysis or the planner match up, such as
+ * a GROUP BY expression and the same expression in the target list, still
+ * match.  An entry is only reused if its normalized query is equal to the
+ * one made from the new statement, so after a change of the objects the
+ * query uses, a new entry is made.
+ *
+ * Otherwise, only identical query strings share an entry, and *params is
+ * set to NULL.  The statement is still run through parse analysis every
+ * time, and the entry is only reused if it was made for an equal analyzed
+ * query: the result of parse analysis depends on more than the string, as
+ * literals such as 'now' or dates are converted according to the current
+ * time and settings, and names are looked up through the current
+ * search_path.
+ */
+CachedPlanSource *
+GetSimpleQueryPlan(RawStmt *parsetree, const char *query_string,
+				   CommandTag commandTag, ParamListInfo *params)
+{
+	CachedPlanSource *plansource;
+	NormalizeSimpleQueryContext context;
+	Query	   *query;
+	Query	   *normalized;
+	List	   *querytree_list;
+	Oid		   *param_types;
+	ParamListInfo paramLI;
+	uint64		hashkey;
+	int			nparams;
+	int			i;
+	ListCell   *lc;
+
+	*params = NULL;
+
+	query = parse_analyze_fixedparams(parsetree, query_string, NULL, 0, NULL);
+
+	if (!IsQueryIdEnabled())
+	{
+		hashkey = hash_bytes_extended((const unsigned char *) query_string,
+									  strlen(query_string), 0);
+		plansource = FetchSimpleQueryPlan(hashkey, query);
+		if (plansource == NULL)
+		{
+			plansource = CreateCachedPlanForQuery(query, query_string,
+												  commandTag);
+			querytree_list = pg_rewrite_query(query);
+			CompleteCachedPlan(plansource, querytree_list, NULL,
+							   NULL, 0, NULL, NULL,
+							   CURSOR_OPT_PARALLEL_OK,
+							   false);	/* result type may change */
+			StoreSimpleQueryPlan(hashkey, plansource);
+		}
+		return plansource;
+	}
+
+	context.consts = NIL;
+	normalized = (Query *) normalize_simple_query_mutator((Node *) query,
+														  &context);
+	nparams = list_length(context.consts);
+
+	param_types = (Oid *) palloc(Max(nparams, 1) * sizeof(Oid));
+	paramLI = makeParamList(nparams);
+	i = 0;
+	foreach(lc, context.consts)
+	{
+		Const	   *con = lfirst_node(Const, lc);
+		ParamExternData *prm = &paramLI->params[i];
+
+		param_types[i] = con->consttype;
+		prm->value = con->constvalue;
+		prm->isnull = con->constisnull;
+		prm->pflags = PARAM_FLAG_CONST;
+		prm->ptype = con->consttype;
+		i++;
+	}
+
+	/*
+	 * Lists of constants of different lengths may have the same query ID, so
+	 * mix in the number of parameters to keep them apart.
+	 */
+	hashkey = hash_combine64((uint64) query->queryId, (uint64) nparams);
+	plansource = FetchSimpleQueryPlan(hashkey, normalized);
+	if (plansource == NULL)
+	{
+		plansource = CreateCachedPlanForQuery(normalized, query_string,
+											  commandTag);
+		querytree_list = pg_rewrite_query(normalized);
+		CompleteCachedPlan(plansource, querytree_list, NULL,
+						   param_types, nparams, NULL, NULL,
+						   CURSOR_OPT_PARALLEL_OK,
+						   false);	/* result type may change */
+		StoreSimpleQueryPlan(hashkey, plansource);
+	}
+
+	/*
+	 * Without parameters, pass none, so that the generic plan is used right
+	 * away rather than making custom plans that can be no better.
+	 */
+	if (nparams > 0)
+		*params = paramLI;
+	return plansource;
+}
+
+/*
+ * Replace the constants written in a query by parameters.
+ *
+ * Constants made up by parse analysis have no location, and are left alone,
+ * as are constants of type unknown.  The constants inside a table function
+ * are left alone too, since the path expressions of JSON_TABLE must be
+ * constants, as are those in the arbiter clauses of INSERT ... ON CONFLICT,
+ * which the planner matches against index definitions.
+ */
+static Node *
+normalize_simple_query_mutator(Node *node,
+							   NormalizeSimpleQueryContext *context)
+{
+	if (node == NULL)
+		return NULL;
+	if (IsA(node, Const))
+	{
+		Const	   *con = (Const *) node;
+		Param	   *param;
+		int			paramid = 0;
+		ListCell   *lc;
+
+		if (con->location < 0 || con->consttype == UNKNOWNOID)
+			return (Node *) copyObject(con);
+
+		foreach(lc, context->consts)
+		{
+			if (equal(lfirst(lc), con))
+			{
+				paramid = foreach_current_index(lc) + 1;
+				break;
+			}
+		}
+		if (paramid == 0)
+		{
+			context->consts = lappend(context->consts, con);
+			paramid = list_length(context->consts);
+		}
+
+		param = makeNode(Param);
+		param->paramkind = PARAM_EXTERN;
+		param->paramid = paramid;
+		param->paramtype = con->consttype;
+		param->paramtypmod = con->consttypmod;
+		param->paramcollid = con->constcollid;
+		param->location = con->location;
+		return (Node *) param;
+	}
+	if (IsA(node, TableFunc))
+		return (Node *) copyObject(node);
+	if (IsA(node, OnConflictExpr))
+	{
+		OnConflictExpr *onconflict = (OnConflictExpr *) node;
+		OnConflictExpr *newnode;
+
+		newnode = copyObject(onconflict);
+		newnode->onConflictSet = (List *)
+			normalize_simple_query_mutator((Node *) onconflict->onConflictSet,
+										   context);
+		newnode->onConflictWhere =
+			normalize_simple_query_mutator(onconflict->onConflictWhere,
+										   context);
+		return (Node *) newnode;
+	}
+	if (IsA(node, Query))
+		return (Node *) query_tree_mutator((Query *) node,
+										   normalize_simple_query_mutator,
+										   context, 0);
+	return expression_tree_mutator(node, normalize_simple_query_mutator,
+								   context);
+}
+
+/*
+ * Look up the cached plan of a simple-query statement, or return NULL if
+ * there is none.  The entry must have been made for a query equal to the
+ * given analyzed (and possibly normalized) one.
+ */
+static CachedPlanSource *
+FetchSimpleQueryPlan(uint64 hashkey, Query *query)
+{
+	SimpleQueryEntry *entry;
+	CachedPlanSource *plansource;
+
+	if (!simple_queries)
+		return NULL;
+
+	entry = (SimpleQueryEntry *) hash_search(simple_queries,
+											 &hashkey,
+											 HASH_FIND,
+											 NULL);
+	if (!entry)
+		return NULL;
+
+	plansource = entry->plansource;
+	if (plansource->analyzed_parse_tree == NULL ||
+		!equal(plansource->analyzed_parse_tree, query))
+		return NULL;
+
+	dlist_move_head(&simple_query_lru, &entry->lru_node);
+
+	return plansource;
+}
+
+/*
+ * Store the plan of a simple-query statement in the cache, replacing the
+ * entry with the same hash key if there is one, and otherwise evicting the
+ * least recently used entries if the cache is full.  As for
+ * StorePreparedStatement, the passed CachedPlanSource should be "unsaved".
+ */
+static void
+StoreSimpleQueryPlan(uint64 hashkey, CachedPlanSource *plansource)
+{
+	SimpleQueryEntry *entry;
+	bool		found;
+
+	if (!simple_queries)
+	{
+		HASHCTL		hash_ctl;
+
+		hash_ctl.keysize = sizeof(uint64);
+		hash_ctl.entrysize = sizeof(SimpleQueryEntry);
+
+		simple_queries = hash_create("Simple query plans",
+									 64,
+									 &hash_ctl,
+									 HASH_ELEM | HASH_BLOBS);
+	}
+
+	entry = (SimpleQueryEntry *) hash_search(simple_queries,
+											 &hashkey,
+											 HASH_FIND,
+											 &found);
+	if (found)
+	{
+		/* Replace the entry for a colliding or changed statement */
+		DropCachedPlan(entry->plansource);
+		dlist_delete(&entry->lru_node);
+	}
+	else
+	{
+		/* Make room, in case the cache is full or has been made smaller */
+		while (!dlist_is_empty(&simple_query_lru) &&
+			   hash_get_num_entries(simple_queries) >= plan_cache_simple_queries)
+			DropSimpleQueryEntry(dlist_tail_element(SimpleQueryEntry, lru_node,
+													&simple_query_lru));
+
+		entry = (SimpleQueryEntry *) hash_search(simple_queries,
+												 &hashkey,
+												 HASH_ENTER,
+												 NULL);
+	}
+
+	entry->plansource = plansource;
+	dlist_push_head(&simple_query_lru, &entry->lru_node);
+
+	SaveCachedPlan(plansource);
+}
+
+/*
+ * GUC assign_hook for plan_cache_simple_queries
+ *
+ * Statements can only share cached plans across different constants if
+ * query IDs are computed, so ask for that, as pg_stat_statements does.  It
+ * makes no difference unless compute_query_id is "auto".
+ */
+void
+assign_plan_cache_simple_queries(int newval, void *extra)
+{
+	if (newval > 0)
+		EnableQueryId();
+}
+
+/*
+ * Drop all plans cached for simple-query statements.
+ */
+void
+DropAllSimpleQueryPlans(void)
+{
+	while (!dlist_is_empty(&simple_query_lru))
+		DropSimpleQueryEntry(dlist_head_element(SimpleQueryEntry, lru_node,
+												&simple_query_lru));
+}
+
+/*
+ * Release one entry of the simple query plan cache.
+ */
+static void
+DropSimpleQueryEntry(SimpleQueryEntry *entry)
+{
+	DropCachedPlan(entry->plansource);
+	dlist_delete(&entry->lru_node);
+	hash_search(simple_queries, &entry->hashkey, HASH_REMOVE, NULL);
+}
+
 /*
  * Implements the 'EXPLAIN EXECUTE' utility statement.
  *
@@ -37,6 +37,7 @@
  */
 #include "postgres.h"
 
+#include "access/parallel.h"
 #include "access/sysattr.h"
 #include "access/table.h"
 #include "access/tableam.h"
@@ -51,7 +52,9 @@
 #include "foreign/fdwapi.h"
 #include "mb/pg_wchar.h"
 #include "miscadmin.h"
+#include "nodes/nodeFuncs.h"
 #include "nodes/queryjumble.h"
+#include "optimizer/cardfeedback.h"
 #include "parser/parse_relation.h"
 #include "pgstat.h"
 #include "rewrite/rewriteHandler.h"
@@ -78,6 +81,7 @@ static void InitPlan(QueryDesc *queryDesc, int eflags);
 static void CheckValidRowMarkRel(Relation rel, RowMarkType markType);
 static void ExecPostprocessPlan(EState *estate);
 static void ExecEndPlan(PlanState *planstate, EState *estate);
+static bool ExecReportCardinalityFeedback(PlanState *planstate, void *context);
 static void ExecutePlan(QueryDesc *queryDesc,
 						CmdType operation,
 						bool sendTuples,
@@ -503,6 +507,14 @@ standard_ExecutorEnd(QueryDesc *queryDesc)
 
 	ExecEndPlan(queryDesc->planstate, estate);
 
+	/*
+	 * Report the actual row counts of scans to cardinality feedback.  The
+	 * scans concerned are not parallel-aware, so each process returns all of
+	 * their rows, and parallel workers leave the reporting to the leader.
+	 */
+	if (cardinality_feedback && !IsParallelWorker())
+		ExecReportCardinalityFeedback(queryDesc->planstate, NULL);
+
 	/* do away with our snapshots */
 	UnregisterSnapshot(estate->es_snapshot);
 	UnregisterSnapshot(estate->es_crosscheck_snapshot);
@@ -1524,6 +1536,31 @@ ExecPostprocessPlan(EState *estate)
 	}
 }
 
+/*
+ * ExecReportCardinalityFeedback
+ *		Report the row counts of the plan's scans that the planner tagged
+ *		with a cardinality feedback key.
+ *
+ * Scans that never ran to completion have no completed loops, and are not
+ * reported.
+ */
+static bool
+ExecReportCardinalityFeedback(PlanState *planstate, void *context)
+{
+	if (ExecIsFeedbackScan(planstate))
+	{
+		ScanState  *ss = (ScanState *) planstate;
+
+		if (ss->ss_feedback_nloops > 0)
+			cardinality_feedback_record(((Scan *) planstate->plan)->feedback_key,
+										ss->ss_feedback_ntuples /
+										ss->ss_feedback_nloops);
+	}
+
+	return planstate_tree_walker(planstate, ExecReportCardinalityFeedback,
+								 context);
+}
+
 /* ----------------------------------------------------------------
  *		ExecEndPlan
  *
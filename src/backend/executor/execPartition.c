@@ -33,6 +33,7 @@
 #include "utils/partcache.h"
 #include "utils/rls.h"
 #include "utils/ruleutils.h"
+#include "utils/snapmgr.h"
 
 
 /*-----------------------
@@ -2004,6 +2005,65 @@ ExecDoInitialPruning(EState *estate)
 	}
 }
 
+/*
+ * ExecGetInitialUnprunedRelids
+ *		Perform initial partition pruning for a PlannedStmt outside of the
+ *		executor proper, and return the RT indexes of the prunable relations
+ *		that the executor may open.
+ *
+ * This is used by the plan cache to find out which partitions it needs to
+ * lock before a generic plan is executed with the given parameter values.
+ * The caller must hold locks on all the relations in the plan's
+ * unprunableRelids; the partitioned tables whose partition descriptors are
+ * used for pruning are among those.
+ *
+ * Besides the leaf partitions that survive pruning, the result includes the
+ * first result relation of each ModifyTable node, which ExecInitModifyTable()
+ * opens even if it was pruned.
+ *
+ * It's up to the caller to make sure that the executor will arrive at the
+ * same result, or a subset of it: the pruning steps must not depend on
+ * anything but the parameter values.  The partition descriptors used for
+ * pruning include partitions that are being detached concurrently, and
+ * partitions attached concurrently are not in the plan, so those can only
+ * make the executor's result smaller.
+ *
+ * The returned set is allocated in the caller's memory context.
+ */
+Bitmapset *
+ExecGetInitialUnprunedRelids(PlannedStmt *plannedstmt, ParamListInfo params)
+{
+	EState	   *estate;
+	MemoryContext oldcxt;
+	Bitmapset  *result;
+
+	estate = CreateExecutorState();
+	oldcxt = MemoryContextSwitchTo(estate->es_query_cxt);
+
+	estate->es_param_list_info = params;
+	estate->es_snapshot = GetActiveSnapshot();
+	ExecInitRangeTable(estate, plannedstmt->rtable, plannedstmt->permInfos,
+					   bms_copy(plannedstmt->unprunableRelids));
+	estate->es_plannedstmt = plannedstmt;
+	estate->es_part_prune_infos = plannedstmt->partPruneInfos;
+
+	ExecDoInitialPruning(estate);
+
+	MemoryContextSwitchTo(oldcxt);
+
+	foreach_int(rti, plannedstmt->firstResultRels)
+		estate->es_unpruned_relids = bms_add_member(estate->es_unpruned_relids,
+													rti);
+
+	result = bms_difference(estate->es_unpruned_relids,
+							plannedstmt->unprunableRelids);
+
+	ExecCloseRangeTableRelations(estate);
+	FreeExecutorState(estate);
+
+	return result;
+}
+
 /*
  * ExecInitPartitionExecPruning
  *		Initialize the data structures needed for runtime "exec" partition
@@ -121,6 +121,7 @@
 
 static TupleTableSlot *ExecProcNodeFirst(PlanState *node);
 static TupleTableSlot *ExecProcNodeInstr(PlanState *node);
+static TupleTableSlot *ExecProcNodeFeedback(PlanState *node);
 static bool ExecShutdownNode_walker(PlanState *node, void *context);
 
 
@@ -458,10 +459,13 @@ ExecProcNodeFirst(PlanState *node)
 
 	/*
 	 * If instrumentation is required, change the wrapper to one that just
-	 * does instrumentation.  Otherwise we can dispense with all wrappers and
-	 * have ExecProcNode() directly call the relevant function from now on.
+	 * does instrumentation, or to one that also counts rows for cardinality
+	 * feedback.  Otherwise we can dispense with all wrappers and have
+	 * ExecProcNode() directly call the relevant function from now on.
 	 */
-	if (node->instrument)
+	if (ExecIsFeedbackScan(node))
+		node->ExecProcNode = ExecProcNodeFeedback;
+	else if (node->instrument)
 		node->ExecProcNode = ExecProcNodeInstr;
 	else
 		node->ExecProcNode = node->ExecProcNodeReal;
@@ -490,6 +494,69 @@ ExecProcNodeInstr(PlanState *node)
 }
 
 
+/*
+ * ExecIsFeedbackScan
+ *		Does this node count the rows it returns for cardinality feedback?
+ *
+ * Only scans that the planner tagged with a feedback key do.  A scan that
+ * can be run backwards might be counted twice or only partially, so it is
+ * left out, as is one that may be restored to a mark, like the inner side
+ * of a merge join, since it returns rows again after ExecRestrPos().
+ */
+bool
+ExecIsFeedbackScan(PlanState *node)
+{
+	switch (nodeTag(node->plan))
+	{
+		case T_SeqScan:
+		case T_IndexScan:
+		case T_IndexOnlyScan:
+		case T_BitmapHeapScan:
+		case T_TidScan:
+		case T_TidRangeScan:
+			return ((Scan *) node->plan)->feedback_key != 0 &&
+				!((ScanState *) node)->ss_feedback_mark &&
+				!(node->state->es_top_eflags &
+				  (EXEC_FLAG_BACKWARD | EXEC_FLAG_EXPLAIN_ONLY));
+		default:
+			return false;
+	}
+}
+
+/*
+ * ExecProcNode wrapper that counts the rows returned by a scan for
+ * cardinality feedback (see ExecIsFeedbackScan), besides doing
+ * instrumentation if that is required.
+ *
+ * Only loops that run to the end of the scan are counted, since a scan
+ * that was stopped early, for example by a LIMIT or by a semi-join that
+ * found its match, did not return all of its rows.  ExecScanReScan()
+ * discards the count of an unfinished loop.
+ */
+static TupleTableSlot *
+ExecProcNodeFeedback(PlanState *node)
+{
+	ScanState  *ss = (ScanState *) node;
+	TupleTableSlot *result;
+
+	if (node->instrument)
+		result = ExecProcNodeInstr(node);
+	else
+		result = node->ExecProcNodeReal(node);
+
+	if (!TupIsNull(result))
+		ss->ss_feedback_tuples += 1;
+	else if (!ss->ss_feedback_done)
+	{
+		ss->ss_feedback_ntuples += ss->ss_feedback_tuples;
+		ss->ss_feedback_nloops += 1;
+		ss->ss_feedback_done = true;
+	}
+
+	return result;
+}
+
+
 /* ----------------------------------------------------------------
  *		MultiExecProcNode
  *
@@ -115,6 +115,10 @@ ExecScanReScan(ScanState *node)
 	 */
 	ExecClearTuple(node->ss_ScanTupleSlot);
 
+	/* Start a new loop for cardinality feedback, see ExecProcNodeFeedback */
+	node->ss_feedback_tuples = 0;
+	node->ss_feedback_done = false;
+
 	/*
 	 * Rescan EvalPlanQual tuple(s) if we're inside an EvalPlanQual recheck.
 	 * But don't lose the "blocked" status of blocked target relations.
@@ -542,6 +542,7 @@ ExecInitIndexOnlyScan(IndexOnlyScan *node, EState *estate, int eflags)
 	indexstate->ss.ps.plan = (Plan *) node;
 	indexstate->ss.ps.state = estate;
 	indexstate->ss.ps.ExecProcNode = ExecIndexOnlyScan;
+	indexstate->ss.ss_feedback_mark = (eflags & EXEC_FLAG_MARK) != 0;
 
 	/*
 	 * Miscellaneous initialization
@@ -917,6 +917,7 @@ ExecInitIndexScan(IndexScan *node, EState *estate, int eflags)
 	indexstate->ss.ps.plan = (Plan *) node;
 	indexstate->ss.ps.state = estate;
 	indexstate->ss.ps.ExecProcNode = ExecIndexScan;
+	indexstate->ss.ss_feedback_mark = (eflags & EXEC_FLAG_MARK) != 0;
 
 	/*
 	 * Miscellaneous initialization
@@ -4664,8 +4664,8 @@ ExecInitModifyTable(ModifyTable *node, EState *estate, int eflags)
 	 * as a reference for building the ResultRelInfo of the target partition.
 	 * In either case, it doesn't matter which result relation is kept, so we
 	 * just keep the first one, if all others have been pruned.  See also,
-	 * ExecDoInitialPruning(), which ensures that this first result relation
-	 * has been locked.
+	 * ExecGetInitialUnprunedRelids(), which ensures that the plan cache locks
+	 * this first result relation.
 	 */
 	i = 0;
 	foreach(l, node->resultRelations)
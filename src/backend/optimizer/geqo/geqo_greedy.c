@@ -0,0 +1,313 @@
+/*------------------------------------------------------------------------
+ *
+ * geqo_greedy.c
+ *	  Greedy join order search, an alternative to the genetic algorithm
+ *
+ * This implements Greedy Operator Ordering: starting from the base
+ * relations, repeatedly perform the legal join that produces the smallest
+ * estimated result, until only one relation is left.  It is deterministic,
+ * and the planning effort grows only with the cube of the number of
+ * relations, so it is a reasonable choice for queries that are too large
+ * for the exhaustive search in standard_join_search().
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/backend/optimizer/geqo/geqo_greedy.c
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include "optimizer/geqo.h"
+#include "optimizer/joininfo.h"
+#include "optimizer/pathnode.h"
+#include "optimizer/paths.h"
+#include "utils/hsearch.h"
+#include "utils/memutils.h"
+
+
+/* What is known about joining the clumps in two slots */
+typedef struct GreedyPair
+{
+	bool		checked;		/* have the fields below been filled in? */
+	bool		desirable;		/* join clause or join order restriction? */
+	bool		evaluated;		/* have legal and rows been filled in? */
+	bool		legal;			/* can the clumps be joined at all? */
+	Cardinality rows;			/* estimated size of the join, if legal */
+} GreedyPair;
+
+static bool greedy_best_join(PlannerInfo *root, MemoryContext evalcxt,
+							 RelOptInfo **clumps, GreedyPair *pairs,
+							 int nslots, bool force,
+							 int *outer_idx, int *inner_idx);
+static bool greedy_eval_join(PlannerInfo *root, MemoryContext evalcxt,
+							 RelOptInfo *outer_rel, RelOptInfo *inner_rel,
+							 Cardinality *rows);
+static void greedy_finish_joinrel(PlannerInfo *root, RelOptInfo *joinrel);
+
+
+/*
+ * geqo_greedy
+ *	  Find a join order for the given relations by greedy search.
+ *
+ * Returns the final join relation, or NULL if the greedy choices led to a
+ * dead end from which no legal join order can be completed (which can only
+ * happen in the presence of LATERAL references or join order restrictions).
+ * In that case, all join relations built here are forgotten again, so that
+ * the caller can fall back to the genetic search.
+ *
+ * The input relations are kept in an array of slots.  When two clumps are
+ * joined, the result takes the slot of the first one and the slot of the
+ * second one is emptied.  What we learn about each pair of slots is kept
+ * until one of them changes, since it depends only on the two clumps; so
+ * each possible join is estimated just once.
+ */
+RelOptInfo *
+geqo_greedy(PlannerInfo *root, int number_of_rels, List *initial_rels)
+{
+	MemoryContext evalcxt;
+	RelOptInfo **clumps;
+	GreedyPair *pairs;
+	int			nslots;
+	int			nclumps;
+	int			savelength;
+	RelOptInfo *result = NULL;
+
+	Assert(root->join_rel_level == NULL);
+	savelength = list_length(root->join_rel_list);
+
+	/*
+	 * Candidate joins are built in a private memory context, which is reset
+	 * after each of them, in the same way as geqo_eval() does for a whole
+	 * tour.  Only the joins that are chosen get built for real.  Note we
+	 * make the context a child of the planner's normal context, so that it
+	 * will be freed even if we abort via ereport(ERROR).
+	 */
+	evalcxt = AllocSetContextCreate(CurrentMemoryContext,
+									"GEQO greedy",
+									ALLOCSET_DEFAULT_SIZES);
+
+	/* Each of the input relations starts out as a clump of its own */
+	nslots = list_length(initial_rels);
+	clumps = palloc_array(RelOptInfo *, nslots);
+	for (int i = 0; i < nslots; i++)
+		clumps[i] = (RelOptInfo *) list_nth(initial_rels, i);
+	pairs = palloc0_array(GreedyPair, nslots * nslots);
+
+	for (nclumps = nslots; nclumps > 1; nclumps--)
+	{
+		RelOptInfo *joinrel;
+		int			outer_idx;
+		int			inner_idx;
+
+		/*
+		 * Prefer joins that have a join clause or are forced by a join order
+		 * restriction.  Only if there are none, consider cartesian products.
+		 */
+		if (!greedy_best_join(root, evalcxt, clumps, pairs, nslots, false,
+							  &outer_idx, &inner_idx) &&
+			!greedy_best_join(root, evalcxt, clumps, pairs, nslots, true,
+							  &outer_idx, &inner_idx))
+			break;				/* dead end */
+
+		joinrel = make_join_rel(root, clumps[outer_idx], clumps[inner_idx]);
+		if (joinrel == NULL)
+			elog(ERROR, "failed to build a join that was found to be legal");
+		greedy_finish_joinrel(root, joinrel);
+
+		/* Replace the two input clumps with the new one */
+		clumps[outer_idx] = joinrel;
+		clumps[inner_idx] = NULL;
+
+		/* Forget what we knew about pairs involving the new clump */
+		for (int k = 0; k < nslots; k++)
+		{
+			memset(&pairs[outer_idx * nslots + k], 0, sizeof(GreedyPair));
+			memset(&pairs[k * nslots + outer_idx], 0, sizeof(GreedyPair));
+		}
+	}
+
+	if (nclumps == 1)
+	{
+		for (int i = 0; i < nslots; i++)
+		{
+			if (clumps[i] != NULL)
+				result = clumps[i];
+		}
+	}
+	else
+	{
+		ListCell   *lc;
+
+		/*
+		 * Dead end.  Remove the join relations we built from the hash table,
+		 * if there is one, and from join_rel_list.  NOTE this assumes that
+		 * any added entries are appended at the end!
+		 */
+		if (root->join_rel_hash)
+		{
+			for_each_from(lc, root->join_rel_list, savelength)
+			{
+				RelOptInfo *rel = (RelOptInfo *) lfirst(lc);
+
+				hash_search(root->join_rel_hash, &rel->relids,
+							HASH_REMOVE, NULL);
+			}
+		}
+		root->join_rel_list = list_truncate(root->join_rel_list,
+											savelength);
+	}
+
+	MemoryContextDelete(evalcxt);
+	pfree(pairs);
+	pfree(clumps);
+
+	return result;
+}
+
+/*
+ * Find the legal join between two of the current clumps that has the
+ * smallest estimated number of output rows.  Returns false if there is no
+ * legal join; otherwise sets *outer_idx and *inner_idx to the slots of the
+ * clumps to join.
+ *
+ * If force is false, consider only joins that are not cartesian products,
+ * that is, those that gimme_tree() would consider desirable.
+ */
+static bool
+greedy_best_join(PlannerInfo *root, MemoryContext evalcxt,
+				 RelOptInfo **clumps, GreedyPair *pairs, int nslots,
+				 bool force, int *outer_idx, int *inner_idx)
+{
+	GreedyPair *best = NULL;
+
+	for (int i = 0; i < nslots; i++)
+	{
+		RelOptInfo *outer_rel = clumps[i];
+
+		if (outer_rel == NULL)
+			continue;
+
+		for (int j = i + 1; j < nslots; j++)
+		{
+			RelOptInfo *inner_rel = clumps[j];
+			GreedyPair *pair = &pairs[i * nslots + j];
+
+			if (inner_rel == NULL)
+				continue;
+
+			if (!pair->checked)
+			{
+				pair->desirable =
+					have_relevant_joinclause(root, outer_rel, inner_rel) ||
+					have_join_order_restriction(root, outer_rel, inner_rel);
+				pair->checked = true;
+			}
+
+			if (!force && !pair->desirable)
+				continue;
+
+			if (!pair->evaluated)
+			{
+				pair->legal = greedy_eval_join(root, evalcxt,
+											   outer_rel, inner_rel,
+											   &pair->rows);
+				pair->evaluated = true;
+			}
+
+			/* Skip illegal joins */
+			if (!pair->legal)
+				continue;
+
+			if (best == NULL || pair->rows < best->rows)
+			{
+				best = pair;
+				*outer_idx = i;
+				*inner_idx = j;
+			}
+		}
+	}
+
+	return best != NULL;
+}
+
+/*
+ * Build the join between two clumps in the given temporary context, only to
+ * learn whether it is legal and how many rows it is estimated to produce.
+ * Everything built is thrown away again before returning.
+ */
+static bool
+greedy_eval_join(PlannerInfo *root, MemoryContext evalcxt,
+				 RelOptInfo *outer_rel, RelOptInfo *inner_rel,
+				 Cardinality *rows)
+{
+	MemoryContext oldcxt;
+	RelOptInfo *joinrel;
+	int			savelength;
+	struct HTAB *savehash;
+
+	oldcxt = MemoryContextSwitchTo(evalcxt);
+
+	/*
+	 * make_join_rel() will add an entry to root->join_rel_list, and maybe to
+	 * root->join_rel_hash.  Restore both afterwards, as geqo_eval() does.
+	 */
+	savelength = list_length(root->join_rel_list);
+	savehash = root->join_rel_hash;
+	root->join_rel_hash = NULL;
+
+	joinrel = make_join_rel(root, outer_rel, inner_rel);
+	if (joinrel)
+		*rows = joinrel->rows;
+
+	root->join_rel_list = list_truncate(root->join_rel_list, savelength);
+	root->join_rel_hash = savehash;
+
+	MemoryContextSwitchTo(oldcxt);
+	MemoryContextReset(evalcxt);
+
+	return joinrel != NULL;
+}
+
+/*
+ * Complete the paths of a join relation chosen by the greedy search, so
+ * that it can be used as input for further joins.  This matches what
+ * merge_clump() does for the genetic search.
+ */
+static void
+greedy_finish_joinrel(PlannerInfo *root, RelOptInfo *joinrel)
+{
+	bool		is_top_rel = bms_equal(joinrel->relids, root->all_query_rels);
+
+	/* Create paths for partitionwise joins. */
+	generate_partitionwise_join_paths(root, joinrel);
+
+	/*
+	 * Except for the topmost scan/join rel, consider gathering partial paths.
+	 * We'll do the same for the topmost scan/join rel once we know the final
+	 * targetlist (see grouping_planner).
+	 */
+	if (!is_top_rel)
+		generate_useful_gather_paths(root, joinrel, false);
+
+	/* Find and save the cheapest paths for this joinrel */
+	set_cheapest(joinrel);
+
+	/*
+	 * Except for the topmost scan/join rel, consider generating partial
+	 * aggregation paths for the grouped relation on top of the paths of this
+	 * rel.  After that, we're done creating paths for the grouped relation,
+	 * so run set_cheapest().
+	 */
+	if (joinrel->grouped_rel != NULL && !is_top_rel)
+	{
+		RelOptInfo *grouped_rel = joinrel->grouped_rel;
+
+		Assert(IS_GROUPED_REL(grouped_rel));
+
+		generate_grouped_paths(root, grouped_rel, joinrel);
+		set_cheapest(grouped_rel);
+	}
+}
@@ -46,6 +46,7 @@ int			Geqo_pool_size;
 int			Geqo_generations;
 double		Geqo_selection_bias;
 double		Geqo_seed;
+int			Geqo_strategy;
 
 /* GEQO is treated as an in-core planner extension */
 int			Geqo_planner_extension_id = -1;
@@ -3846,7 +3846,18 @@ make_rel_from_joinlist(PlannerInfo *root, List *joinlist)
 		if (join_search_hook)
 			return (*join_search_hook) (root, levels_needed, initial_rels);
 		else if (enable_geqo && levels_needed >= geqo_threshold)
+		{
+			/* If the greedy search reaches a dead end, use GEQO instead */
+			if (Geqo_strategy == GEQO_STRATEGY_GREEDY)
+			{
+				RelOptInfo *rel = geqo_greedy(root, levels_needed,
+											  initial_rels);
+
+				if (rel)
+					return rel;
+			}
 			return geqo(root, levels_needed, initial_rels);
+		}
 		else
 			return standard_join_search(root, levels_needed, initial_rels);
 	}
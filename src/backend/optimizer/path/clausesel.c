@@ -154,6 +154,16 @@ clauselist_selectivity_ext(PlannerInfo *root,
 											jointype, sjinfo, rel,
 											&estimatedclauses, false);
 	}
+	else if (use_extended_stats && rel == NULL && varRelid == 0)
+	{
+		/*
+		 * These may be join clauses.  Estimate equijoins on several columns
+		 * of the same pair of relations together, if there are ndistinct
+		 * statistics for those columns.
+		 */
+		s1 = statext_join_clauselist_selectivity(root, clauses, jointype,
+												 &estimatedclauses);
+	}
 
 	/*
 	 * Apply normal selectivity estimates for remaining clauses. We'll be
@@ -95,6 +95,7 @@
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "nodes/nodeFuncs.h"
+#include "optimizer/cardfeedback.h"
 #include "optimizer/clauses.h"
 #include "optimizer/cost.h"
 #include "optimizer/optimizer.h"
@@ -5491,11 +5492,17 @@ approx_tuple_count(PlannerInfo *root, JoinPath *path, List *quals)
  *		  restriction clauses).
  *	width: the estimated average output tuple width in bytes.
  *	baserestrictcost: estimated cost of evaluating baserestrictinfo clauses.
+ *	feedback_key: key identifying the rel in the cardinality feedback table.
+ *
+ * If cardinality feedback has recorded how many rows a scan of the rel with
+ * the same restriction clauses actually returned, we believe that rather
+ * than our own estimate.
  */
 void
 set_baserel_size_estimates(PlannerInfo *root, RelOptInfo *rel)
 {
 	double		nrows;
+	double		feedback_rows;
 
 	/* Should only be applied to base relations */
 	Assert(rel->relid > 0);
@@ -5507,6 +5514,10 @@ set_baserel_size_estimates(PlannerInfo *root, RelOptInfo *rel)
 							   JOIN_INNER,
 							   NULL);
 
+	rel->feedback_key = cardinality_feedback_key(root, rel);
+	if (cardinality_feedback_lookup(rel->feedback_key, &feedback_rows))
+		nrows = Min(feedback_rows, rel->tuples);
+
 	rel->rows = clamp_row_est(nrows);
 
 	cost_qual_eval(&rel->baserestrictcost, rel->baserestrictinfo, root);
@@ -795,6 +795,20 @@ create_scan_plan(PlannerInfo *root, Path *best_path, int flags)
 			break;
 	}
 
+	/*
+	 * Let the executor report the actual row count of scans of plain tables
+	 * to cardinality feedback.  Parameterized scans return only a subset of
+	 * the rel's rows, so they are not comparable and we leave them out, as
+	 * well as parallel-aware ones, which return only part of the rows in
+	 * each process.
+	 */
+	if (rel->feedback_key != 0 && best_path->param_info == NULL &&
+		!best_path->parallel_aware &&
+		(IsA(plan, SeqScan) || IsA(plan, IndexScan) ||
+		 IsA(plan, IndexOnlyScan) || IsA(plan, BitmapHeapScan) ||
+		 IsA(plan, TidScan) || IsA(plan, TidRangeScan)))
+		((Scan *) plan)->feedback_key = rel->feedback_key;
+
 	/*
 	 * If there are any pseudoconstant clauses attached to this node, insert a
 	 * gating Result node that evaluates the pseudoconstants as one-time
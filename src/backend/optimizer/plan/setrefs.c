@@ -274,7 +274,8 @@ static List *set_windowagg_runcondition_references(PlannerInfo *root,
  *
  * The flattened rangetable entries are appended to root->glob->finalrtable.
  * Also, rowmarks entries are appended to root->glob->finalrowmarks, and the
- * RT indexes of ModifyTable result relations to root->glob->resultRelations,
+ * RT indexes of ModifyTable result relations to root->glob->resultRelations
+ * (and the first one of each ModifyTable to root->glob->firstResultRels),
  * and flattened AppendRelInfos are appended to root->glob->appendRelations.
  * Plan dependencies are appended to root->glob->relationOids (for relations)
  * and root->glob->invalItems (for everything else).
@@ -1268,6 +1269,9 @@ set_plan_refs(PlannerInfo *root, Plan *plan, int rtoffset)
 				root->glob->resultRelations =
 					list_concat(root->glob->resultRelations,
 								splan->resultRelations);
+				root->glob->firstResultRels =
+					lappend_int(root->glob->firstResultRels,
+								linitial_int(splan->resultRelations));
 				if (splan->rootRelation)
 				{
 					root->glob->resultRelations =
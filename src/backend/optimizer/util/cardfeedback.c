@@ -0,0 +1,290 @@
+/*-------------------------------------------------------------------------
+ *
+ * cardfeedback.c
+ *	  Feedback of observed scan cardinalities into row count estimation.
+ *
+ * When cardinality_feedback is enabled, each unparameterized scan of a
+ * plain table is tagged at plan time with a key that identifies the table
+ * together with its restriction clauses.  The executor counts the rows
+ * returned by such scans, and at executor end the row count of each scan
+ * that was run to completion is stored in a shared hash table under that
+ * key.  Subsequent plannings of a scan with the same key use the stored
+ * row count in place of the estimate computed from the statistics.  This
+ * helps for queries whose restriction clauses are correlated in ways that
+ * the statistics do not capture, and which are executed repeatedly.
+ *
+ * Scans that were stopped early, by a LIMIT, a semi-join, a cursor that was
+ * not fetched to the end or the like, are not recorded, since they did not
+ * return all of their rows; see ExecProcNodeFeedback().  Every observation
+ * is averaged into the existing entry, so that old observations decay away
+ * and an entry made obsolete by changes to the table is gradually
+ * corrected.  The number of entries is limited by
+ * cardinality_feedback_max_entries; when the table is full, the entries
+ * that were least recently updated are evicted, a few percent at a time.
+ *
+ * The table is shared by all sessions, so the row counts observed by one
+ * role, possibly filtered by row-level security policies, affect the plans
+ * of others.  That is why cardinality_feedback can only be set by
+ * superusers.
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ *
+ * IDENTIFICATION
+ *	  src/backend/optimizer/util/cardfeedback.c
+ *
+ *-------------------------------------------------------------------------
+ */
+#include "postgres.h"
+
+#include "catalog/pg_class.h"
+#include "common/hashfn.h"
+#include "common/int.h"
+#include "miscadmin.h"
+#include "nodes/pathnodes.h"
+#include "optimizer/cardfeedback.h"
+#include "parser/parsetree.h"
+#include "rewrite/rewriteManip.h"
+#include "storage/lwlock.h"
+#include "storage/shmem.h"
+#include "utils/hsearch.h"
+
+/* GUC parameters */
+bool		cardinality_feedback = false;
+int			cardinality_feedback_max_entries = 1000;
+
+#define FEEDBACK_DEALLOC_PERCENT	5	/* evict this % of entries at once */
+
+typedef struct CardinalityFeedbackEntry
+{
+	uint64		key;			/* hash key; must be first */
+	double		rows;			/* averaged observed row count */
+	uint64		last_update;	/* value of CardinalityFeedbackShared->clock */
+} CardinalityFeedbackEntry;
+
+typedef struct CardinalityFeedbackShared
+{
+	uint64		clock;			/* incremented at each update */
+} CardinalityFeedbackShared;
+
+static CardinalityFeedbackShared *FeedbackShared = NULL;
+static HTAB *FeedbackHash = NULL;
+
+static void feedback_entry_dealloc(void);
+
+
+/*
+ * Report shared-memory space needed by CardinalityFeedbackShmemInit
+ */
+Size
+CardinalityFeedbackShmemSize(void)
+{
+	Size		size;
+
+	size = MAXALIGN(sizeof(CardinalityFeedbackShared));
+	size = add_size(size, hash_estimate_size(cardinality_feedback_max_entries,
+											 sizeof(CardinalityFeedbackEntry)));
+	return size;
+}
+
+/*
+ * Allocate and initialize the shared feedback table
+ */
+void
+CardinalityFeedbackShmemInit(void)
+{
+	HASHCTL		info;
+	bool		found;
+
+	if (cardinality_feedback_max_entries <= 0)
+		return;
+
+	FeedbackShared = (CardinalityFeedbackShared *)
+		ShmemInitStruct("Cardinality Feedback Data",
+						sizeof(CardinalityFeedbackShared),
+						&found);
+	if (!found)
+		FeedbackShared->clock = 0;
+
+	info.keysize = sizeof(uint64);
+	info.entrysize = sizeof(CardinalityFeedbackEntry);
+	FeedbackHash = ShmemInitHash("Cardinality Feedback hash",
+								 cardinality_feedback_max_entries,
+								 cardinality_feedback_max_entries,
+								 &info,
+								 HASH_ELEM | HASH_BLOBS | HASH_FIXED_SIZE);
+}
+
+/*
+ * cardinality_feedback_key
+ *		Compute the feedback key of a base relation, or 0 if the relation
+ *		is not eligible for cardinality feedback.
+ *
+ * The key is a hash of the database's and the table's OIDs and of the
+ * table's restriction clauses, with the clauses' range table index
+ * normalized so that the same query (or another one with the same
+ * restrictions on the table) maps to the same key regardless of where the
+ * table appears in the range table.  The database's OID is needed since the
+ * same table OID can be used in different databases.
+ */
+uint64
+cardinality_feedback_key(PlannerInfo *root, RelOptInfo *rel)
+{
+	RangeTblEntry *rte;
+	List	   *clauses = NIL;
+	ListCell   *lc;
+	char	   *str;
+	uint64		key;
+
+	if (!cardinality_feedback || FeedbackHash == NULL)
+		return 0;
+
+	/* Only tables scanned by the executor itself, and not when sampled */
+	if (rel->rtekind != RTE_RELATION)
+		return 0;
+	rte = planner_rt_fetch(rel->relid, root);
+	if (rte->relkind == RELKIND_FOREIGN_TABLE || rte->tablesample != NULL)
+		return 0;
+
+	foreach(lc, rel->baserestrictinfo)
+	{
+		RestrictInfo *rinfo = lfirst_node(RestrictInfo, lc);
+
+		clauses = lappend(clauses, copyObject(rinfo->clause));
+	}
+	ChangeVarNodes((Node *) clauses, rel->relid, 1, 0);
+
+	str = nodeToString(clauses);
+	key = DatumGetUInt64(hash_any_extended((const unsigned char *) str,
+										   strlen(str),
+										   ((uint64) MyDatabaseId << 32) |
+										   rte->relid));
+	pfree(str);
+
+	/* 0 means "no key" */
+	return key != 0 ? key : 1;
+}
+
+/*
+ * cardinality_feedback_lookup
+ *		Look up the observed row count for the given key.
+ *
+ * Returns true and sets *rows if there is an entry for the key.
+ */
+bool
+cardinality_feedback_lookup(uint64 key, double *rows)
+{
+	CardinalityFeedbackEntry *entry;
+	bool		found = false;
+
+	if (key == 0 || FeedbackHash == NULL)
+		return false;
+
+	LWLockAcquire(CardinalityFeedbackLock, LW_SHARED);
+	entry = (CardinalityFeedbackEntry *) hash_search(FeedbackHash, &key,
+													 HASH_FIND, NULL);
+	if (entry != NULL)
+	{
+		*rows = entry->rows;
+		found = true;
+	}
+	LWLockRelease(CardinalityFeedbackLock);
+
+	return found;
+}
+
+/*
+ * qsort comparator for sorting into increasing last_update order
+ */
+static int
+entry_cmp(const void *lhs, const void *rhs)
+{
+	uint64		l = (*(CardinalityFeedbackEntry *const *) lhs)->last_update;
+	uint64		r = (*(CardinalityFeedbackEntry *const *) rhs)->last_update;
+
+	return pg_cmp_u64(l, r);
+}
+
+/*
+ * Evict the least recently updated entries, to make room for new ones.
+ * As in pg_stat_statements, a percentage of the entries is evicted at once,
+ * so that the whole table needn't be scanned every time a new key comes in
+ * while it is full.
+ *
+ * Caller must hold an exclusive lock on CardinalityFeedbackLock.
+ */
+static void
+feedback_entry_dealloc(void)
+{
+	HASH_SEQ_STATUS hash_seq;
+	CardinalityFeedbackEntry **entries;
+	CardinalityFeedbackEntry *entry;
+	int			nvictims;
+	int			i;
+
+	entries = palloc(hash_get_num_entries(FeedbackHash) *
+					 sizeof(CardinalityFeedbackEntry *));
+
+	i = 0;
+	hash_seq_init(&hash_seq, FeedbackHash);
+	while ((entry = hash_seq_search(&hash_seq)) != NULL)
+		entries[i++] = entry;
+
+	qsort(entries, i, sizeof(CardinalityFeedbackEntry *), entry_cmp);
+
+	nvictims = Max(10, i * FEEDBACK_DEALLOC_PERCENT / 100);
+	nvictims = Min(nvictims, i);
+
+	for (i = 0; i < nvictims; i++)
+		hash_search(FeedbackHash, &entries[i]->key, HASH_REMOVE, NULL);
+
+	pfree(entries);
+}
+
+/*
+ * cardinality_feedback_record
+ *		Record an observed row count for the given key.
+ *
+ * 'actual' is the row count the scan produced when run to completion.
+ */
+void
+cardinality_feedback_record(uint64 key, double actual)
+{
+	CardinalityFeedbackEntry *entry;
+	bool		found;
+
+	if (key == 0 || FeedbackHash == NULL)
+		return;
+
+	LWLockAcquire(CardinalityFeedbackLock, LW_EXCLUSIVE);
+
+	entry = (CardinalityFeedbackEntry *) hash_search(FeedbackHash, &key,
+													 HASH_FIND, NULL);
+	if (entry == NULL)
+	{
+		/* Make room if the table is full */
+		if (hash_get_num_entries(FeedbackHash) >= cardinality_feedback_max_entries)
+			feedback_entry_dealloc();
+
+		entry = (CardinalityFeedbackEntry *) hash_search(FeedbackHash, &key,
+														 HASH_ENTER_NULL,
+														 &found);
+		if (entry == NULL)
+		{
+			LWLockRelease(CardinalityFeedbackLock);
+			return;
+		}
+		Assert(!found);
+		entry->rows = actual;
+	}
+	else
+	{
+		/* Give the new observation the same weight as all previous ones */
+		entry->rows = (entry->rows + actual) / 2;
+	}
+
+	entry->last_update = ++FeedbackShared->clock;
+
+	LWLockRelease(CardinalityFeedbackLock);
+}
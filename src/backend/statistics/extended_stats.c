@@ -29,6 +29,7 @@
 #include "miscadmin.h"
 #include "nodes/nodeFuncs.h"
 #include "optimizer/optimizer.h"
+#include "optimizer/pathnode.h"
 #include "parser/parsetree.h"
 #include "pgstat.h"
 #include "postmaster/autovacuum.h"
@@ -2016,6 +2017,250 @@ statext_clauselist_selectivity(PlannerInfo *root, List *clauses, int varRelid,
 	return sel;
 }
 
+/*
+ * A group of equijoin clauses between the same two relations, for
+ * statext_join_clauselist_selectivity.  relid1 is the lower of the two.
+ */
+typedef struct JoinClauseGroup
+{
+	Index		relid1;
+	Index		relid2;
+	Bitmapset  *attnums1;		/* columns of relid1 used by the clauses */
+	Bitmapset  *attnums2;		/* columns of relid2 used by the clauses */
+	Bitmapset  *clauseidxs;		/* list positions of the clauses */
+	int			nclauses;
+} JoinClauseGroup;
+
+/*
+ * statext_join_clause_vars
+ *		Check whether a clause is an equijoin between plain columns of two
+ *		different relations, and if so, return the two Vars with the one of
+ *		the lower-numbered relation first.
+ */
+static bool
+statext_join_clause_vars(Node *clause, Var **var1, Var **var2)
+{
+	OpExpr	   *expr;
+	Node	   *left;
+	Node	   *right;
+
+	if (IsA(clause, RestrictInfo))
+	{
+		RestrictInfo *rinfo = (RestrictInfo *) clause;
+
+		if (rinfo->pseudoconstant)
+			return false;
+		clause = (Node *) rinfo->clause;
+	}
+
+	if (!is_opclause(clause))
+		return false;
+
+	expr = (OpExpr *) clause;
+	if (list_length(expr->args) != 2 ||
+		get_oprjoin(expr->opno) != F_EQJOINSEL)
+		return false;
+
+	left = (Node *) linitial(expr->args);
+	right = (Node *) lsecond(expr->args);
+
+	/* strip binary-compatible relabeling, as examine_variable does */
+	if (IsA(left, RelabelType))
+		left = (Node *) ((RelabelType *) left)->arg;
+	if (IsA(right, RelabelType))
+		right = (Node *) ((RelabelType *) right)->arg;
+
+	if (!IsA(left, Var) || !IsA(right, Var))
+		return false;
+
+	*var1 = (Var *) left;
+	*var2 = (Var *) right;
+
+	if ((*var1)->varlevelsup != 0 || (*var2)->varlevelsup != 0 ||
+		(*var1)->varno == (*var2)->varno ||
+		!AttrNumberIsForUserDefinedAttr((*var1)->varattno) ||
+		!AttrNumberIsForUserDefinedAttr((*var2)->varattno))
+		return false;
+
+	if ((*var1)->varno > (*var2)->varno)
+	{
+		Var		   *tmp = *var1;
+
+		*var1 = *var2;
+		*var2 = tmp;
+	}
+
+	return true;
+}
+
+/*
+ * statext_join_ndistinct
+ *		Look up the number of distinct combinations of the given columns of
+ *		a relation in its ndistinct statistics.  Returns -1 if there is no
+ *		statistics object covering exactly these columns.
+ */
+static double
+statext_join_ndistinct(PlannerInfo *root, Index relid, Bitmapset *attnums)
+{
+	RelOptInfo *rel = find_base_rel_noerr(root, relid);
+	RangeTblEntry *rte;
+	ListCell   *lc;
+
+	if (rel == NULL || rel->rtekind != RTE_RELATION || rel->statlist == NIL)
+		return -1;
+
+	rte = planner_rt_fetch(relid, root);
+
+	foreach(lc, rel->statlist)
+	{
+		StatisticExtInfo *info = (StatisticExtInfo *) lfirst(lc);
+		MVNDistinct *stats;
+		int			i;
+
+		if (info->kind != STATS_EXT_NDISTINCT ||
+			info->inherit != rte->inh ||
+			!bms_is_subset(attnums, info->keys))
+			continue;
+
+		stats = statext_ndistinct_load(info->statOid, rte->inh);
+		if (stats == NULL)
+			continue;
+
+		/* Find the item for exactly this combination of columns */
+		for (i = 0; i < stats->nitems; i++)
+		{
+			MVNDistinctItem *item = &stats->items[i];
+			int			j;
+
+			if (item->nattributes != bms_num_members(attnums))
+				continue;
+
+			for (j = 0; j < item->nattributes; j++)
+			{
+				/* expressions have negative attnums, and never match */
+				if (item->attributes[j] < 0 ||
+					!bms_is_member(item->attributes[j], attnums))
+					break;
+			}
+
+			/*
+			 * There can't be more distinct combinations than the rows we
+			 * estimate the relation to return, so clamp to that, as
+			 * eqjoinsel_semi() does for a single column.  Without this,
+			 * restrictions on the relation would not reduce the estimate.
+			 */
+			if (j == item->nattributes)
+				return Min(item->ndistinct, rel->rows);
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * statext_join_clauselist_selectivity
+ *		Estimate groups of equijoin clauses using ndistinct statistics.
+ *
+ * Multiplying the selectivities of the individual clauses of a join on
+ * several columns, like "a.x = b.x AND a.y = b.y", assumes that the columns
+ * are independent, which badly underestimates the join size when they are
+ * correlated.  If both relations have ndistinct statistics on the columns
+ * involved, we instead treat the group of clauses as a single equijoin on
+ * the combined key, and estimate it the way eqjoinsel_inner() does in the
+ * absence of MCV lists: as 1 / max(nd1, nd2), where nd1 and nd2 are the
+ * numbers of distinct combinations on either side, each clamped to the
+ * estimated number of rows of its relation.  NULLs are not accounted for,
+ * which can only make the estimate higher.
+ *
+ * Only inner, left and full joins are handled, since semijoins and
+ * antijoins need a different estimate.  The list positions of the clauses
+ * estimated here are added to *estimatedclauses.
+ */
+Selectivity
+statext_join_clauselist_selectivity(PlannerInfo *root, List *clauses,
+									JoinType jointype,
+									Bitmapset **estimatedclauses)
+{
+	Selectivity sel = 1.0;
+	List	   *groups = NIL;
+	ListCell   *lc;
+	int			listidx;
+
+	if (jointype != JOIN_INNER && jointype != JOIN_LEFT &&
+		jointype != JOIN_FULL)
+		return sel;
+
+	/* Sort the equijoin clauses into groups by the pair of relations */
+	listidx = -1;
+	foreach(lc, clauses)
+	{
+		JoinClauseGroup *group = NULL;
+		Var		   *var1;
+		Var		   *var2;
+		ListCell   *lc2;
+
+		listidx++;
+
+		if (bms_is_member(listidx, *estimatedclauses) ||
+			!statext_join_clause_vars((Node *) lfirst(lc), &var1, &var2))
+			continue;
+
+		foreach(lc2, groups)
+		{
+			JoinClauseGroup *g = (JoinClauseGroup *) lfirst(lc2);
+
+			if (g->relid1 == var1->varno && g->relid2 == var2->varno)
+			{
+				group = g;
+				break;
+			}
+		}
+
+		if (group == NULL)
+		{
+			group = palloc0_object(JoinClauseGroup);
+			group->relid1 = var1->varno;
+			group->relid2 = var2->varno;
+			groups = lappend(groups, group);
+		}
+
+		group->attnums1 = bms_add_member(group->attnums1, var1->varattno);
+		group->attnums2 = bms_add_member(group->attnums2, var2->varattno);
+		group->clauseidxs = bms_add_member(group->clauseidxs, listidx);
+		group->nclauses++;
+	}
+
+	foreach(lc, groups)
+	{
+		JoinClauseGroup *group = (JoinClauseGroup *) lfirst(lc);
+		double		nd1;
+		double		nd2;
+
+		/*
+		 * ndistinct statistics only cover combinations of two or more
+		 * columns.  Also skip groups that use a column twice on one side,
+		 * which don't correspond to a join on a combined key.
+		 */
+		if (group->nclauses < 2 ||
+			bms_num_members(group->attnums1) != group->nclauses ||
+			bms_num_members(group->attnums2) != group->nclauses)
+			continue;
+
+		nd1 = statext_join_ndistinct(root, group->relid1, group->attnums1);
+		if (nd1 < 1)
+			continue;
+		nd2 = statext_join_ndistinct(root, group->relid2, group->attnums2);
+		if (nd2 < 1)
+			continue;
+
+		sel *= 1.0 / Max(nd1, nd2);
+		*estimatedclauses = bms_add_members(*estimatedclauses,
+											group->clauseidxs);
+	}
+
+	return sel;
+}
+
 /*
  * examine_opclause_args
  *		Split an operator expression's arguments into Expr and Const parts.
@@ -63,6 +63,7 @@
 #include "storage/smgr.h"
 #include "storage/standby.h"
 #include "utils/memdebug.h"
+#include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/rel.h"
 #include "utils/resowner.h"
@@ -77,9 +78,16 @@
 #define LocalBufHdrGetBlock(bufHdr) \
 	LocalBufferBlockPointers[-((bufHdr)->buf_id + 2)]
 
-/* Bits in SyncOneBuffer's return value */
+/* Bits in SyncOneBuffer's and BgCheckBuffer's return value */
 #define BUF_WRITTEN				0x01
 #define BUF_REUSABLE			0x02
+#define BUF_NEEDS_WRITE			0x04
+
+/*
+ * Maximum number of dirty buffers the background writer collects before
+ * sorting them and issuing (combined) writes.
+ */
+#define BGWRITER_BATCH_SIZE		256
 
 #define RELS_BSEARCH_THRESHOLD		20
 
@@ -91,6 +99,17 @@
  */
 #define BUF_DROP_FULL_SCAN_THRESHOLD		(uint64) (NBuffers / 32)
 
+/*
+ * A dirty buffer queued for writing by the background writer, see
+ * BgBufferSync().  The tag is used to sort the batch into block order, and to
+ * recheck that the buffer still holds the same page when it is written.
+ */
+typedef struct BgWriteCandidate
+{
+	int			buf_id;
+	BufferTag	tag;
+} BgWriteCandidate;
+
 /*
  * This is separated out from PrivateRefCountEntry to allow for copying all
  * the data members via struct assignment.
@@ -626,6 +645,9 @@ static void UnpinBufferNoOwner(BufferDesc *buf);
 static void BufferSync(int flags);
 static int	SyncOneBuffer(int buf_id, bool skip_recently_used,
 						  WritebackContext *wb_context);
+static int	BgCheckBuffer(int buf_id, BufferTag *tag);
+static void BgWriteBatch(BgWriteCandidate *batch, int nbatch,
+						 WritebackContext *wb_context);
 static void WaitIO(BufferDesc *buf);
 static void AbortBufferIO(Buffer buffer);
 static void shared_buffer_write_error_callback(void *arg);
@@ -3770,6 +3792,8 @@ BgBufferSync(WritebackContext *wb_context)
 	int			num_to_scan;
 	int			num_written;
 	int			reusable_buffers;
+	BgWriteCandidate batch[BGWRITER_BATCH_SIZE];
+	int			nbatch;
 
 	/* Variables for final smoothed_density update */
 	long		new_strategy_delta;
@@ -3950,12 +3974,24 @@ BgBufferSync(WritebackContext *wb_context)
 	num_to_scan = bufs_to_lap;
 	num_written = 0;
 	reusable_buffers = reusable_buffers_est;
+	nbatch = 0;
 
-	/* Execute the LRU scan */
+	/*
+	 * Execute the LRU scan.  Rather than writing each dirty buffer as soon as
+	 * we find it, collect a batch of them, so that BgWriteBatch() can write
+	 * them in block order and combine writes of adjacent blocks of the same
+	 * relation fork.  A queued buffer is counted as written and reusable
+	 * right away; if it turns out to have been cleaned or used by the time
+	 * we get to it, the estimate is off a bit, which is no worse than
+	 * SyncOneBuffer() finding the buffer clean after locking it.
+	 */
 	while (num_to_scan > 0 && reusable_buffers < upcoming_alloc_est)
 	{
-		int			sync_state = SyncOneBuffer(next_to_clean, true,
-											   wb_context);
+		int			sync_state = BgCheckBuffer(next_to_clean,
+											   &batch[nbatch].tag);
+
+		if (sync_state & BUF_NEEDS_WRITE)
+			batch[nbatch++].buf_id = next_to_clean;
 
 		if (++next_to_clean >= NBuffers)
 		{
@@ -3964,8 +4000,14 @@ BgBufferSync(WritebackContext *wb_context)
 		}
 		num_to_scan--;
 
-		if (sync_state & BUF_WRITTEN)
+		if (sync_state & BUF_NEEDS_WRITE)
 		{
+			if (nbatch >= BGWRITER_BATCH_SIZE)
+			{
+				BgWriteBatch(batch, nbatch, wb_context);
+				nbatch = 0;
+			}
+
 			reusable_buffers++;
 			if (++num_written >= bgwriter_lru_maxpages)
 			{
@@ -3977,6 +4019,10 @@ BgBufferSync(WritebackContext *wb_context)
 			reusable_buffers++;
 	}
 
+	/* Write out whatever is left in the batch */
+	if (nbatch > 0)
+		BgWriteBatch(batch, nbatch, wb_context);
+
 	PendingBgWriterStats.buf_written_clean += num_written;
 
 #ifdef BGW_DEBUG
@@ -4092,6 +4138,299 @@ SyncOneBuffer(int buf_id, bool skip_recently_used, WritebackContext *wb_context)
 	return result | BUF_WRITTEN;
 }
 
+#define ST_SORT sort_bgwriter_batch
+#define ST_ELEMENT_TYPE BgWriteCandidate
+#define ST_COMPARE(a, b) buffertag_comparator(&a->tag, &b->tag)
+#define ST_SCOPE static
+#define ST_DEFINE
+#include "lib/sort_template.h"
+
+/*
+ * BgCheckBuffer -- check whether the background writer should write a buffer.
+ *
+ * Like SyncOneBuffer() with skip_recently_used = true, except that we only
+ * look at the buffer, without pinning or writing it.  If the buffer is a
+ * dirty replacement candidate, its tag is stored into *tag, so that
+ * BgWriteBatch() can later verify that it still holds the same page.
+ *
+ * Returns a bitmask containing the following flag bits:
+ *	BUF_REUSABLE: buffer is available for replacement, ie, it has
+ *		pin count 0 and usage count 0.
+ *	BUF_NEEDS_WRITE: buffer is reusable, valid and dirty.
+ */
+static int
+BgCheckBuffer(int buf_id, BufferTag *tag)
+{
+	BufferDesc *bufHdr = GetBufferDescriptor(buf_id);
+	int			result = 0;
+	uint64		buf_state;
+
+	/*
+	 * As in SyncOneBuffer(), it's OK to check this without the buffer content
+	 * lock.  The tag is only stable while we hold the header lock, though.
+	 */
+	buf_state = LockBufHdr(bufHdr);
+
+	if (BUF_STATE_GET_REFCOUNT(buf_state) == 0 &&
+		BUF_STATE_GET_USAGECOUNT(buf_state) == 0)
+	{
+		result |= BUF_REUSABLE;
+
+		if ((buf_state & BM_VALID) && (buf_state & BM_DIRTY))
+		{
+			*tag = bufHdr->tag;
+			result |= BUF_NEEDS_WRITE;
+		}
+	}
+
+	UnlockBufHdr(bufHdr);
+
+	return result;
+}
+
+/*
+ * BgStartBufferWrite -- prepare a queued buffer for writing.
+ *
+ * Pins and share-locks the buffer, and starts a write I/O on it, provided it
+ * still holds the page recorded in the candidate and is still a dirty
+ * replacement candidate.  Returns the buffer descriptor, or NULL if the
+ * buffer no longer needs to be written by us.
+ *
+ * If nowait is true, give up rather than wait for the content lock or for an
+ * I/O in progress.  The caller must pass true whenever it already holds
+ * content locks on other buffers, since we could otherwise deadlock against
+ * a backend that acquires the same buffer locks in a different order.
+ */
+static BufferDesc *
+BgStartBufferWrite(BgWriteCandidate *candidate, bool nowait)
+{
+	BufferDesc *bufHdr = GetBufferDescriptor(candidate->buf_id);
+	Buffer		buffer = BufferDescriptorGetBuffer(bufHdr);
+	uint64		buf_state;
+
+	/* Make sure we can handle the pin */
+	ReservePrivateRefCountEntry();
+	ResourceOwnerEnlarge(CurrentResourceOwner);
+
+	buf_state = LockBufHdr(bufHdr);
+
+	if (!BufferTagsEqual(&bufHdr->tag, &candidate->tag) ||
+		BUF_STATE_GET_REFCOUNT(buf_state) != 0 ||
+		BUF_STATE_GET_USAGECOUNT(buf_state) != 0 ||
+		!(buf_state & BM_VALID) || !(buf_state & BM_DIRTY))
+	{
+		UnlockBufHdr(bufHdr);
+		return NULL;
+	}
+
+	PinBuffer_Locked(bufHdr);
+
+	if (nowait)
+	{
+		if (!BufferLockConditional(buffer, bufHdr, BUFFER_LOCK_SHARE))
+		{
+			UnpinBuffer(bufHdr);
+			return NULL;
+		}
+	}
+	else
+		BufferLockAcquire(buffer, bufHdr, BUFFER_LOCK_SHARE);
+
+	/*
+	 * If StartBufferIO returns false, then someone else flushed the buffer
+	 * before we could (or, with nowait, is flushing it right now).
+	 */
+	if (!StartBufferIO(bufHdr, false, nowait))
+	{
+		BufferLockUnlock(buffer, bufHdr);
+		UnpinBuffer(bufHdr);
+		return NULL;
+	}
+
+	return bufHdr;
+}
+
+/*
+ * BgWriteRun -- write out a run of buffers holding consecutive blocks.
+ *
+ * All buffers must belong to the same relation fork, be ordered by block
+ * number, and have been prepared with BgStartBufferWrite().  This is the
+ * multi-buffer equivalent of FlushBuffer(): we flush WAL up to the highest
+ * LSN of the run, and issue a single vectored write for all the blocks.
+ * The buffers are unlocked and unpinned before returning.
+ */
+static void
+BgWriteRun(BufferDesc **run, int nrun, WritebackContext *wb_context)
+{
+	static char *checksum_copies = NULL;
+	const void *blocks[MAX_IO_COMBINE_LIMIT];
+	BufferTag	tag = run[0]->tag;
+	XLogRecPtr	max_lsn = InvalidXLogRecPtr;
+	bool		permanent = false;
+	ErrorContextCallback errcallback;
+	instr_time	io_start;
+	SMgrRelation reln;
+
+	Assert(nrun > 0 && nrun <= MAX_IO_COMBINE_LIMIT);
+
+	/* Setup error traceback support for ereport() */
+	errcallback.callback = shared_buffer_write_error_callback;
+	errcallback.arg = run[0];
+	errcallback.previous = error_context_stack;
+	error_context_stack = &errcallback;
+
+	reln = smgropen(BufTagGetRelFileLocator(&tag), INVALID_PROC_NUMBER);
+
+	for (int i = 0; i < nrun; i++)
+	{
+		BufferDesc *buf = run[i];
+		uint64		buf_state;
+		XLogRecPtr	recptr;
+
+		Assert(BufTagGetForkNum(&buf->tag) == BufTagGetForkNum(&tag));
+		Assert(buf->tag.blockNum == tag.blockNum + i);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_START(BufTagGetForkNum(&buf->tag),
+											buf->tag.blockNum,
+											reln->smgr_rlocator.locator.spcOid,
+											reln->smgr_rlocator.locator.dbOid,
+											reln->smgr_rlocator.locator.relNumber);
+
+		/* See FlushBuffer() */
+		buf_state = LockBufHdr(buf);
+		recptr = BufferGetLSN(buf);
+		UnlockBufHdrExt(buf, buf_state,
+						0, BM_JUST_DIRTIED,
+						0);
+
+		if (buf_state & BM_PERMANENT)
+		{
+			permanent = true;
+			if (recptr > max_lsn)
+				max_lsn = recptr;
+		}
+	}
+
+	/* Obey the WAL-before-data rule for the whole run at once */
+	if (permanent)
+		XLogFlush(max_lsn);
+
+	/*
+	 * As in FlushBuffer(), checksums must be computed on private copies of
+	 * the pages, since we hold only share locks on the buffers.
+	 * PageSetChecksumCopy() has room for just one page, so keep our own copy
+	 * space, big enough for the largest possible run.
+	 */
+	if (DataChecksumsEnabled() && checksum_copies == NULL)
+		checksum_copies = MemoryContextAllocAligned(TopMemoryContext,
+													(Size) MAX_IO_COMBINE_LIMIT * BLCKSZ,
+													PG_IO_ALIGN_SIZE,
+													0);
+
+	for (int i = 0; i < nrun; i++)
+	{
+		Block		bufBlock = BufHdrGetBlock(run[i]);
+
+		if (DataChecksumsEnabled())
+		{
+			char	   *copy = checksum_copies + (Size) i * BLCKSZ;
+
+			memcpy(copy, bufBlock, BLCKSZ);
+			PageSetChecksumInplace((Page) copy, tag.blockNum + i);
+			blocks[i] = copy;
+		}
+		else
+			blocks[i] = bufBlock;
+	}
+
+	io_start = pgstat_prepare_io_time(track_io_timing);
+
+	smgrwritev(reln, BufTagGetForkNum(&tag), tag.blockNum, blocks, nrun,
+			   false);
+
+	/* The background writer only ever writes in the normal IOContext */
+	pgstat_count_io_op_time(IOOBJECT_RELATION, IOCONTEXT_NORMAL,
+							IOOP_WRITE, io_start, nrun, (uint64) nrun * BLCKSZ);
+
+	pgBufferUsage.shared_blks_written += nrun;
+
+	for (int i = 0; i < nrun; i++)
+	{
+		BufferDesc *buf = run[i];
+		BufferTag	buftag = buf->tag;
+
+		/*
+		 * Mark the buffer as clean (unless BM_JUST_DIRTIED has become set)
+		 * and end the BM_IO_IN_PROGRESS state.
+		 */
+		TerminateBufferIO(buf, true, 0, true, false);
+
+		TRACE_POSTGRESQL_BUFFER_FLUSH_DONE(BufTagGetForkNum(&buftag),
+										   buftag.blockNum,
+										   reln->smgr_rlocator.locator.spcOid,
+										   reln->smgr_rlocator.locator.dbOid,
+										   reln->smgr_rlocator.locator.relNumber);
+
+		BufferLockUnlock(BufferDescriptorGetBuffer(buf), buf);
+		UnpinBuffer(buf);
+
+		ScheduleBufferTagForWriteback(wb_context, IOCONTEXT_NORMAL, &buftag);
+	}
+
+	/* Pop the error context stack */
+	error_context_stack = errcallback.previous;
+}
+
+/*
+ * BgWriteBatch -- write out a batch of buffers queued by BgBufferSync.
+ *
+ * The batch is sorted into block order, and runs of buffers holding
+ * consecutive blocks of the same relation fork are written with a single
+ * vectored write, up to io_combine_limit blocks at a time.  Buffers that have
+ * been cleaned, used or evicted since they were queued are skipped.
+ */
+static void
+BgWriteBatch(BgWriteCandidate *batch, int nbatch, WritebackContext *wb_context)
+{
+	BufferDesc *run[MAX_IO_COMBINE_LIMIT];
+	int			i = 0;
+
+	sort_bgwriter_batch(batch, nbatch);
+
+	while (i < nbatch)
+	{
+		int			nrun;
+
+		/*
+		 * Start a new run.  We don't hold any other buffer locks at this
+		 * point, so it's safe to wait for the first buffer's lock.
+		 */
+		run[0] = BgStartBufferWrite(&batch[i++], false);
+		if (run[0] == NULL)
+			continue;
+		nrun = 1;
+
+		/* Extend the run with the following blocks, if we can */
+		while (i < nbatch && nrun < io_combine_limit)
+		{
+			BgWriteCandidate *next = &batch[i];
+			BufferTag	expected = run[nrun - 1]->tag;
+
+			expected.blockNum++;
+			if (!BufferTagsEqual(&next->tag, &expected))
+				break;
+
+			run[nrun] = BgStartBufferWrite(next, true);
+			if (run[nrun] == NULL)
+				break;
+			nrun++;
+			i++;
+		}
+
+		BgWriteRun(run, nrun, wb_context);
+	}
+}
+
 /*
  *		AtEOXact_Buffers - clean up at end of transaction.
  *
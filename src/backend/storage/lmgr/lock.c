@@ -44,6 +44,7 @@
 #include "storage/procarray.h"
 #include "storage/spin.h"
 #include "storage/standby.h"
+#include "utils/guc_hooks.h"
 #include "utils/memutils.h"
 #include "utils/ps_status.h"
 #include "utils/resowner.h"
@@ -51,6 +52,7 @@
 
 /* GUC variables */
 int			max_locks_per_xact; /* used to set the lock table size */
+int			lock_manager_partitions = DEFAULT_LOCK_PARTITIONS;
 bool		log_lock_failures = false;
 
 #define NLOCKENTS() \
@@ -585,12 +587,13 @@ proclock_hash(const void *key, Size keysize)
 	/*
 	 * To make the hash code also depend on the PGPROC, we xor the proc
 	 * struct's address into the hash code, left-shifted so that the
-	 * partition-number bits don't change.  Since this is only a hash, we
-	 * don't care if we lose high-order bits of the address; use an
-	 * intermediate variable to suppress cast-pointer-to-int warnings.
+	 * partition-number bits don't change, whatever the number of partitions.
+	 * Since this is only a hash, we don't care if we lose high-order bits of
+	 * the address; use an intermediate variable to suppress
+	 * cast-pointer-to-int warnings.
 	 */
 	procptr = PointerGetDatum(proclocktag->myProc);
-	lockhash ^= DatumGetUInt32(procptr) << LOG2_NUM_LOCK_PARTITIONS;
+	lockhash ^= DatumGetUInt32(procptr) << LOG2_MAX_LOCK_PARTITIONS;
 
 	return lockhash;
 }
@@ -611,7 +614,7 @@ ProcLockHashCode(const PROCLOCKTAG *proclocktag, uint32 hashcode)
 	 * This must match proclock_hash()!
 	 */
 	procptr = PointerGetDatum(proclocktag->myProc);
-	lockhash ^= DatumGetUInt32(procptr) << LOG2_NUM_LOCK_PARTITIONS;
+	lockhash ^= DatumGetUInt32(procptr) << LOG2_MAX_LOCK_PARTITIONS;
 
 	return lockhash;
 }
@@ -3774,6 +3777,23 @@ LockManagerShmemSize(void)
 	return size;
 }
 
+/*
+ * GUC check_hook for lock_manager_partitions
+ */
+bool
+check_lock_manager_partitions(int *newval, void **extra, GucSource source)
+{
+	/* LockHashPartition() relies on this */
+	if ((*newval & (*newval - 1)) != 0)
+	{
+		GUC_check_errdetail("\"%s\" must be a power of two.",
+							"lock_manager_partitions");
+		return false;
+	}
+
+	return true;
+}
+
 /*
  * GetLockStatusData - Return a summary of the lock manager's internal
  * status, for use in a user-level reporting function.
@@ -133,6 +133,18 @@ FastPathLockShmemSize(void)
 	return size;
 }
 
+/*
+ * Report shared-memory space needed by the per-PGPROC myProcLocks lists.
+ */
+static Size
+ProcLockListsShmemSize(void)
+{
+	Size		TotalProcs =
+		add_size(MaxBackends, add_size(NUM_AUXILIARY_PROCS, max_prepared_xacts));
+
+	return mul_size(TotalProcs, mul_size(NUM_LOCK_PARTITIONS, sizeof(dlist_head)));
+}
+
 /*
  * Report shared-memory space needed by InitProcGlobal.
  */
@@ -148,6 +160,7 @@ ProcGlobalShmemSize(void)
 	size = add_size(size, PGSemaphoreShmemSize(ProcGlobalSemas()));
 	size = add_size(size, PGProcShmemSize());
 	size = add_size(size, FastPathLockShmemSize());
+	size = add_size(size, ProcLockListsShmemSize());
 
 	return size;
 }
@@ -204,6 +217,7 @@ InitProcGlobal(void)
 			   *fpEndPtr PG_USED_FOR_ASSERTS_ONLY;
 	Size		fpLockBitsSize,
 				fpRelIdSize;
+	dlist_head *procLockLists;
 	Size		requestSize;
 	char	   *ptr;
 
@@ -288,6 +302,14 @@ InitProcGlobal(void)
 	/* For asserts checking we did not overflow. */
 	fpEndPtr = fpPtr + requestSize;
 
+	/*
+	 * Likewise, the number of lock partitions is only known at server start,
+	 * so allocate the myProcLocks lists separately too.
+	 */
+	procLockLists = (dlist_head *) ShmemInitStruct("PGPROC Lock Lists",
+												   ProcLockListsShmemSize(),
+												   &found);
+
 	/* Reserve space for semaphores. */
 	PGReserveSemaphores(ProcGlobalSemas());
 
@@ -356,6 +378,8 @@ InitProcGlobal(void)
 		}
 
 		/* Initialize myProcLocks[] shared memory queues. */
+		proc->myProcLocks = procLockLists;
+		procLockLists += NUM_LOCK_PARTITIONS;
 		for (j = 0; j < NUM_LOCK_PARTITIONS; j++)
 			dlist_init(&(proc->myProcLocks[j]));
 
@@ -1106,6 +1106,8 @@ exec_simple_query(const char *query_string)
 		MemoryContext per_parsetree_context = NULL;
 		List	   *querytree_list,
 				   *plantree_list;
+		CachedPlan *cplan = NULL;
+		ParamListInfo params = NULL;
 		Portal		portal;
 		DestReceiver *receiver;
 		int16		format;
@@ -1192,11 +1194,33 @@ exec_simple_query(const char *query_string)
 		else
 			oldcontext = MemoryContextSwitchTo(MessageContext);
 
-		querytree_list = pg_analyze_and_rewrite_fixedparams(parsetree, query_string,
-															NULL, 0, NULL);
+		/*
+		 * If plans of simple queries are being cached and this is the only
+		 * statement in the string, reuse the plan from an earlier execution
+		 * of the same statement if there is one, else make a cache entry.
+		 * The constants of the statement may have been turned into
+		 * parameters.  The plancache takes care of replanning after
+		 * invalidations.
+		 */
+		if (plan_cache_simple_queries > 0 &&
+			list_length(parsetree_list) == 1 &&
+			SimpleQueryIsCacheable(parsetree))
+		{
+			CachedPlanSource *psrc;
+
+			psrc = GetSimpleQueryPlan(parsetree, query_string, commandTag,
+									  &params);
+			cplan = GetCachedPlan(psrc, params, NULL, NULL);
+			plantree_list = cplan->stmt_list;
+		}
+		else
+		{
+			querytree_list = pg_analyze_and_rewrite_fixedparams(parsetree, query_string,
+																NULL, 0, NULL);
 
-		plantree_list = pg_plan_queries(querytree_list, query_string,
-										CURSOR_OPT_PARALLEL_OK, NULL);
+			plantree_list = pg_plan_queries(querytree_list, query_string,
+											CURSOR_OPT_PARALLEL_OK, NULL);
+		}
 
 		/*
 		 * Done with the snapshot used for parsing/planning.
@@ -1225,19 +1249,21 @@ exec_simple_query(const char *query_string)
 		/*
 		 * We don't have to copy anything into the portal, because everything
 		 * we are passing here is in MessageContext or the
-		 * per_parsetree_context, and so will outlive the portal anyway.
+		 * per_parsetree_context, or belongs to the cached plan that the
+		 * portal holds a reference to, and so will outlive the portal anyway.
 		 */
 		PortalDefineQuery(portal,
 						  NULL,
 						  query_string,
 						  commandTag,
 						  plantree_list,
-						  NULL);
+						  cplan);
 
 		/*
-		 * Start the portal.  No parameters here.
+		 * Start the portal.  There are only parameters if the constants of a
+		 * cached statement were replaced by them.
 		 */
-		PortalStart(portal, NULL, 0, InvalidSnapshot);
+		PortalStart(portal, params, 0, InvalidSnapshot);
 
 		/*
 		 * Select the appropriate output format: text unless we are doing a
@@ -35,8 +35,23 @@ static const float default_weights[NUM_WEIGHTS] = {0.1f, 0.2f, 0.4f, 1.0f};
 #define RANK_NORM_RDIVRPLUS1	0x20
 #define DEF_NORM_METHOD			RANK_NO_NORM
 
-static float calc_rank_or(const float *w, TSVector t, TSQuery q);
-static float calc_rank_and(const float *w, TSVector t, TSQuery q);
+/*
+ * The sorted, de-duplicated operands of the query most recently ranked by a
+ * ts_rank() call site, cached in fn_extra.  Ranking typically evaluates the
+ * same query against many documents, and there's no need to sort its
+ * operands again for each of them.
+ */
+typedef struct RankQueryCache
+{
+	TSQuery		query;			/* copy of the query */
+	QueryOperand **items;		/* operands, pointing into 'query' */
+	int			nitems;
+} RankQueryCache;
+
+static float calc_rank_or(const float *w, TSVector t, TSQuery q,
+						  QueryOperand **item, int size);
+static float calc_rank_and(const float *w, TSVector t, TSQuery q,
+						   QueryOperand **item, int size);
 
 /*
  * Returns a weight of a word collocation
@@ -198,7 +213,8 @@ SortAndUniqItems(TSQuery q, int *size)
 }
 
 static float
-calc_rank_and(const float *w, TSVector t, TSQuery q)
+calc_rank_and(const float *w, TSVector t, TSQuery q,
+			  QueryOperand **item, int size)
 {
 	WordEntryPosVector **pos;
 	WordEntryPosVector1 posnull;
@@ -216,15 +232,9 @@ calc_rank_and(const float *w, TSVector t, TSQuery q)
 				dist,
 				nitem;
 	float		res = -1.0;
-	QueryOperand **item;
-	int			size = q->size;
 
-	item = SortAndUniqItems(q, &size);
 	if (size < 2)
-	{
-		pfree(item);
-		return calc_rank_or(w, t, q);
-	}
+		return calc_rank_or(w, t, q, item, size);
 	pos = palloc0_array(WordEntryPosVector *, q->size);
 
 	/* A dummy WordEntryPos array to use when haspos is false */
@@ -276,12 +286,12 @@ calc_rank_and(const float *w, TSVector t, TSQuery q)
 		}
 	}
 	pfree(pos);
-	pfree(item);
 	return res;
 }
 
 static float
-calc_rank_or(const float *w, TSVector t, TSQuery q)
+calc_rank_or(const float *w, TSVector t, TSQuery q,
+			 QueryOperand **item, int size)
 {
 	WordEntry  *entry,
 			   *firstentry;
@@ -292,15 +302,11 @@ calc_rank_or(const float *w, TSVector t, TSQuery q)
 				i,
 				nitem;
 	float		res = 0.0;
-	QueryOperand **item;
-	int			size = q->size;
 
 	/* A dummy WordEntryPos array to use when haspos is false */
 	posnull.npos = 1;
 	posnull.pos[0] = 0;
 
-	item = SortAndUniqItems(q, &size);
-
 	for (i = 0; i < size; i++)
 	{
 		float		resj,
@@ -350,25 +356,94 @@ calc_rank_or(const float *w, TSVector t, TSQuery q)
 	}
 	if (size > 0)
 		res = res / size;
-	pfree(item);
 	return res;
 }
 
+/*
+ * Get the sorted, de-duplicated operands of query 'q', from the cache in
+ * fn_extra if the previous call ranked the same query.  On return, *q may
+ * point to the cached copy of the query, which the operands point into.
+ *
+ * *should_free is set if the caller must pfree the returned array.
+ */
+static QueryOperand **
+getRankQueryOperands(FunctionCallInfo fcinfo, TSQuery *q, int *size,
+					 bool *should_free)
+{
+	RankQueryCache *cache;
+	QueryOperand **items;
+	MemoryContext oldcxt;
+
+	if (fcinfo->flinfo == NULL)
+	{
+		*size = (*q)->size;
+		*should_free = true;
+		return SortAndUniqItems(*q, size);
+	}
+
+	*should_free = false;
+
+	cache = (RankQueryCache *) fcinfo->flinfo->fn_extra;
+	if (cache != NULL &&
+		VARSIZE(cache->query) == VARSIZE(*q) &&
+		memcmp(cache->query, *q, VARSIZE(*q)) == 0)
+	{
+		*q = cache->query;
+		*size = cache->nitems;
+		return cache->items;
+	}
+
+	/* Not cached; build a new cache entry, replacing the old one */
+	oldcxt = MemoryContextSwitchTo(fcinfo->flinfo->fn_mcxt);
+
+	if (cache == NULL)
+	{
+		cache = palloc0_object(RankQueryCache);
+		fcinfo->flinfo->fn_extra = cache;
+	}
+	else
+	{
+		pfree(cache->query);
+		pfree(cache->items);
+	}
+
+	cache->query = (TSQuery) palloc(VARSIZE(*q));
+	memcpy(cache->query, *q, VARSIZE(*q));
+	cache->nitems = cache->query->size;
+	items = SortAndUniqItems(cache->query, &cache->nitems);
+	cache->items = items;
+
+	MemoryContextSwitchTo(oldcxt);
+
+	*q = cache->query;
+	*size = cache->nitems;
+	return items;
+}
+
 static float
-calc_rank(const float *w, TSVector t, TSQuery q, int32 method)
+calc_rank(FunctionCallInfo fcinfo, const float *w, TSVector t, TSQuery q,
+		  int32 method)
 {
 	QueryItem  *item = GETQUERY(q);
+	QueryOperand **operands;
+	int			noperands;
+	bool		should_free;
 	float		res = 0.0;
 	int			len;
 
 	if (!t->size || !q->size)
 		return 0.0;
 
+	operands = getRankQueryOperands(fcinfo, &q, &noperands, &should_free);
+
 	/* XXX: What about NOT? */
 	res = (item->type == QI_OPR && (item->qoperator.oper == OP_AND ||
 									item->qoperator.oper == OP_PHRASE)) ?
-		calc_rank_and(w, t, q) :
-		calc_rank_or(w, t, q);
+		calc_rank_and(w, t, q, operands, noperands) :
+		calc_rank_or(w, t, q, operands, noperands);
+
+	if (should_free)
+		pfree(operands);
 
 	if (res < 0)
 		res = 1e-20f;
@@ -446,7 +521,7 @@ ts_rank_wttf(PG_FUNCTION_ARGS)
 	float		res;
 
 	getWeights(win, weights);
-	res = calc_rank(weights, txt, query, method);
+	res = calc_rank(fcinfo, weights, txt, query, method);
 
 	PG_FREE_IF_COPY(win, 0);
 	PG_FREE_IF_COPY(txt, 1);
@@ -464,7 +539,7 @@ ts_rank_wtt(PG_FUNCTION_ARGS)
 	float		res;
 
 	getWeights(win, weights);
-	res = calc_rank(weights, txt, query, DEF_NORM_METHOD);
+	res = calc_rank(fcinfo, weights, txt, query, DEF_NORM_METHOD);
 
 	PG_FREE_IF_COPY(win, 0);
 	PG_FREE_IF_COPY(txt, 1);
@@ -480,7 +555,7 @@ ts_rank_ttf(PG_FUNCTION_ARGS)
 	int			method = PG_GETARG_INT32(2);
 	float		res;
 
-	res = calc_rank(default_weights, txt, query, method);
+	res = calc_rank(fcinfo, default_weights, txt, query, method);
 
 	PG_FREE_IF_COPY(txt, 0);
 	PG_FREE_IF_COPY(query, 1);
@@ -494,7 +569,7 @@ ts_rank_tt(PG_FUNCTION_ARGS)
 	TSQuery		query = PG_GETARG_TSQUERY(1);
 	float		res;
 
-	res = calc_rank(default_weights, txt, query, DEF_NORM_METHOD);
+	res = calc_rank(fcinfo, default_weights, txt, query, DEF_NORM_METHOD);
 
 	PG_FREE_IF_COPY(txt, 0);
 	PG_FREE_IF_COPY(query, 1);
@@ -1275,6 +1275,181 @@ InitCatCachePhase2(CatCache *cache, bool touch_index)
 	}
 }
 
+/*
+ *		PreloadCatCache
+ *
+ *		Load every tuple of the cache's catalog into the cache with a single
+ *		sequential scan, instead of faulting them in one index probe at a
+ *		time.  This is meant to be used at backend start, so that the first
+ *		queries of a session don't pay for a long series of cache misses.
+ *
+ *		The entries are ordinary positive entries with refcount zero, so
+ *		they are invalidated in the usual way.  Tuples that are already
+ *		present are skipped, and so are tuples that become stale while we
+ *		are detoasting them; those will simply be looked up on demand later.
+ *
+ *		An invalidation processed in the middle of the scan can apply to a
+ *		tuple that the scan has yet to return, and which it would then return
+ *		from the old snapshot, with nothing left to invalidate the entry made
+ *		from it.  So, as SearchCatCacheList() does, we register a list-wide
+ *		"in-progress" entry for the duration of the scan.  If it receives an
+ *		invalidation, we discard the entries added so far and start over.
+ *
+ *		Returns the number of entries added.
+ */
+int
+PreloadCatCache(CatCache *cache)
+{
+	Relation	relation;
+	SysScanDesc scandesc;
+	HeapTuple	ntp;
+	List	   *volatile added = NIL;
+	ListCell   *lc;
+	CatCTup    *ct;
+	CatCInProgress *save_in_progress;
+	CatCInProgress in_progress_ent;
+	int			nadded;
+
+	ConditionalCatalogCacheInitializeCache(cache);
+
+	save_in_progress = catcache_in_progress_stack;
+	in_progress_ent.next = catcache_in_progress_stack;
+	in_progress_ent.cache = cache;
+	in_progress_ent.hash_value = 0;
+	in_progress_ent.list = true;
+	in_progress_ent.dead = false;
+	catcache_in_progress_stack = &in_progress_ent;
+
+	PG_TRY();
+	{
+		relation = table_open(cache->cc_reloid, AccessShareLock);
+
+		do
+		{
+			/*
+			 * If we are retrying, get rid of the entries added on the
+			 * previous iteration, since some of them might have been made
+			 * from stale tuples.  They are pinned, so that an invalidation
+			 * can't free them under us; treat them the way
+			 * CatCacheInvalidate() would.
+			 */
+			foreach(lc, added)
+			{
+				ct = (CatCTup *) lfirst(lc);
+				Assert(ct->refcount > 0);
+				ct->refcount--;
+				if (ct->refcount > 0 ||
+					(ct->c_list && ct->c_list->refcount > 0))
+				{
+					ct->dead = true;
+					if (ct->c_list)
+						ct->c_list->dead = true;
+				}
+				else
+					CatCacheRemoveCTup(cache, ct);
+			}
+			added = NIL;
+			in_progress_ent.dead = false;
+
+			scandesc = systable_beginscan(relation, InvalidOid, false,
+										  NULL, 0, NULL);
+
+			while (HeapTupleIsValid(ntp = systable_getnext(scandesc)) &&
+				   !in_progress_ent.dead)
+			{
+				Datum		arguments[CATCACHE_MAXKEYS] = {0};
+				uint32		hashValue;
+				Index		hashIndex;
+				dlist_iter	iter;
+				bool		found = false;
+
+				for (int i = 0; i < cache->cc_nkeys; i++)
+				{
+					bool		isnull;
+
+					arguments[i] = fastgetattr(ntp, cache->cc_keyno[i],
+											   cache->cc_tupdesc, &isnull);
+					Assert(!isnull);
+				}
+
+				hashValue = CatalogCacheComputeTupleHashValue(cache,
+															  cache->cc_nkeys,
+															  ntp);
+				hashIndex = HASH_INDEX(hashValue, cache->cc_nbuckets);
+
+				dlist_foreach(iter, &cache->cc_bucket[hashIndex])
+				{
+					ct = dlist_container(CatCTup, cache_elem, iter.cur);
+
+					if (ct->dead || ct->hash_value != hashValue)
+						continue;
+					if (CatalogCacheCompareTuple(cache, cache->cc_nkeys,
+												 ct->keys, arguments))
+					{
+						found = true;
+						break;
+					}
+				}
+
+				if (found)
+					continue;
+
+				ct = CatalogCacheCreateEntry(cache, ntp, NULL,
+											 hashValue, hashIndex);
+				if (ct != NULL)
+				{
+					/* Add to the list, then pin, as in SearchCatCacheList */
+					added = lappend(added, ct);
+					ct->refcount++;
+				}
+			}
+
+			systable_endscan(scandesc);
+		} while (in_progress_ent.dead);
+
+		table_close(relation, AccessShareLock);
+	}
+	PG_CATCH();
+	{
+		Assert(catcache_in_progress_stack == &in_progress_ent);
+		catcache_in_progress_stack = save_in_progress;
+
+		foreach(lc, added)
+		{
+			ct = (CatCTup *) lfirst(lc);
+			Assert(ct->refcount > 0);
+			ct->refcount--;
+			if (ct->dead && ct->refcount == 0 &&
+				(ct->c_list == NULL || ct->c_list->refcount == 0))
+				CatCacheRemoveCTup(cache, ct);
+		}
+
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+	Assert(catcache_in_progress_stack == &in_progress_ent);
+	catcache_in_progress_stack = save_in_progress;
+
+	/* Unpin the entries; they stay in the cache with refcount zero */
+	foreach(lc, added)
+	{
+		ct = (CatCTup *) lfirst(lc);
+		Assert(ct->refcount > 0);
+		ct->refcount--;
+	}
+	nadded = list_length(added);
+	list_free(added);
+
+	CACHE_elog(DEBUG2, "PreloadCatCache(%s): added %d tuples, contains %d/%d",
+			   cache->cc_relname, nadded, cache->cc_ntup, CacheHdr->ch_ntup);
+
+#ifdef CATCACHE_STATS
+	cache->cc_newloads += nadded;
+#endif
+
+	return nadded;
+}
+
 
 /*
  *		IndexScanOK
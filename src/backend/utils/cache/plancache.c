@@ -58,11 +58,13 @@
 
 #include "access/transam.h"
 #include "catalog/namespace.h"
+#include "executor/execPartition.h"
 #include "executor/executor.h"
 #include "miscadmin.h"
 #include "nodes/nodeFuncs.h"
 #include "optimizer/optimizer.h"
 #include "parser/analyze.h"
+#include "parser/parsetree.h"
 #include "rewrite/rewriteHandler.h"
 #include "storage/lmgr.h"
 #include "tcop/pquery.h"
@@ -93,14 +95,20 @@ static bool StmtPlanRequiresRevalidation(CachedPlanSource *plansource);
 static bool BuildingPlanRequiresSnapshot(CachedPlanSource *plansource);
 static List *RevalidateCachedQuery(CachedPlanSource *plansource,
 								   QueryEnvironment *queryEnv);
-static bool CheckCachedPlan(CachedPlanSource *plansource);
+static bool CheckCachedPlan(CachedPlanSource *plansource,
+							ParamListInfo boundParams);
 static CachedPlan *BuildCachedPlan(CachedPlanSource *plansource, List *qlist,
 								   ParamListInfo boundParams, QueryEnvironment *queryEnv);
 static bool choose_custom_plan(CachedPlanSource *plansource,
 							   ParamListInfo boundParams);
 static double cached_plan_cost(CachedPlan *plan, bool include_planner);
 static Query *QueryListGetPrimaryStmt(List *stmts);
-static void AcquireExecutorLocks(List *stmt_list, bool acquire);
+static bool CanDeferPrunableLocks(PlannedStmt *plannedstmt);
+static List *GetExecutorLockRelids(List *stmt_list, bool *deferred);
+static void LockInitialUnprunedRelids(List *stmt_list, List *lock_relids,
+									  ParamListInfo boundParams);
+static void AcquireExecutorLocks(List *stmt_list, List *lock_relids,
+								 bool acquire);
 static void AcquirePlannerLocks(List *stmt_list, bool acquire);
 static void ScanQueryForLocks(Query *parsetree, bool acquire);
 static bool ScanQueryWalker(Node *node, bool *acquire);
@@ -945,9 +953,14 @@ RevalidateCachedQuery(CachedPlanSource *plansource,
  *
  * On a "true" return, we have acquired the locks needed to run the plan.
  * (We must do this for the "true" result to be race-condition-free.)
+ *
+ * boundParams are the parameter values the plan is about to be executed
+ * with.  If the plan contains partitions that can be removed by initial
+ * partition pruning, we use them to perform that pruning here, and lock only
+ * the partitions that survive it, rather than every partition in the plan.
  */
 static bool
-CheckCachedPlan(CachedPlanSource *plansource)
+CheckCachedPlan(CachedPlanSource *plansource, ParamListInfo boundParams)
 {
 	CachedPlan *plan = plansource->gplan;
 
@@ -975,13 +988,27 @@ CheckCachedPlan(CachedPlanSource *plansource)
 	 */
 	if (plan->is_valid)
 	{
+		List	   *lock_relids;
+		bool		deferred;
+
 		/*
 		 * Plan must have positive refcount because it is referenced by
 		 * plansource; so no need to fear it disappears under us here.
 		 */
 		Assert(plan->refcount > 0);
 
-		AcquireExecutorLocks(plan->stmt_list, true);
+		/*
+		 * Lock everything except the partitions that initial pruning might
+		 * remove.  If there are any such partitions, and the plan is still
+		 * valid once we hold the other locks, it's safe to run the pruning
+		 * steps of the plan, and then lock the partitions that survive.
+		 */
+		lock_relids = GetExecutorLockRelids(plan->stmt_list, &deferred);
+		AcquireExecutorLocks(plan->stmt_list, lock_relids, true);
+
+		if (deferred && plan->is_valid)
+			LockInitialUnprunedRelids(plan->stmt_list, lock_relids,
+									  boundParams);
 
 		/*
 		 * If plan was transient, check to see if TransactionXmin has
@@ -1003,7 +1030,7 @@ CheckCachedPlan(CachedPlanSource *plansource)
 		}
 
 		/* Oops, the race case happened.  Release useless locks. */
-		AcquireExecutorLocks(plan->stmt_list, false);
+		AcquireExecutorLocks(plan->stmt_list, lock_relids, false);
 	}
 
 	/*
@@ -1315,7 +1342,7 @@ GetCachedPlan(CachedPlanSource *plansource, ParamListInfo boundParams,
 
 	if (!customplan)
 	{
-		if (CheckCachedPlan(plansource))
+		if (CheckCachedPlan(plansource, boundParams))
 		{
 			/* We want a generic plan, and we already have a valid one */
 			plan = plansource->gplan;
@@ -1901,19 +1928,169 @@ QueryListGetPrimaryStmt(List *stmts)
 	return NULL;
 }
 
+/*
+ * CanDeferPrunableLocks: can locking the partitions that initial partition
+ * pruning may remove from this plan be deferred until the pruning has been
+ * done?
+ *
+ * That's only worthwhile if the plan has initial pruning steps, and only safe
+ * if the executor is certain to arrive at the same result when it repeats
+ * the pruning, since it must not open any relation we haven't locked.  So
+ * the pruning expressions must depend on nothing but the parameter values.
+ */
+static bool
+CanDeferPrunableLocks(PlannedStmt *plannedstmt)
+{
+	bool		has_initial_steps = false;
+	ListCell   *lc1;
+
+	if (plannedstmt->commandType == CMD_UTILITY ||
+		plannedstmt->partPruneInfos == NIL)
+		return false;
+
+	foreach(lc1, plannedstmt->partPruneInfos)
+	{
+		PartitionPruneInfo *pruneinfo = lfirst_node(PartitionPruneInfo, lc1);
+		ListCell   *lc2;
+
+		foreach(lc2, pruneinfo->prune_infos)
+		{
+			List	   *prune_infos = (List *) lfirst(lc2);
+			ListCell   *lc3;
+
+			foreach(lc3, prune_infos)
+			{
+				PartitionedRelPruneInfo *pinfo = lfirst_node(PartitionedRelPruneInfo, lc3);
+				ListCell   *lc4;
+
+				foreach(lc4, pinfo->initial_pruning_steps)
+				{
+					PartitionPruneStep *step = (PartitionPruneStep *) lfirst(lc4);
+
+					has_initial_steps = true;
+					if (IsA(step, PartitionPruneStepOp) &&
+						contain_mutable_functions((Node *) ((PartitionPruneStepOp *) step)->exprs))
+						return false;
+				}
+			}
+		}
+	}
+
+	return has_initial_steps;
+}
+
+/*
+ * GetExecutorLockRelids: determine which relations of a cached plan
+ * AcquireExecutorLocks should lock up front.
+ *
+ * Returns a list parallel to stmt_list, holding for each PlannedStmt the set
+ * of RT indexes to lock (NULL for utility statements).  Normally that's every
+ * RT index; but for plans that pass CanDeferPrunableLocks, the relations that
+ * may be removed by initial partition pruning are left out, and *deferred is
+ * set to true.  The caller must then lock the relations that survive pruning
+ * using LockInitialUnprunedRelids.
+ *
+ * To be on the safe side, we only defer locking if there's an active
+ * snapshot for the pruning to run with.
+ */
+static List *
+GetExecutorLockRelids(List *stmt_list, bool *deferred)
+{
+	List	   *result = NIL;
+	bool		can_defer = ActiveSnapshotSet();
+	ListCell   *lc;
+
+	*deferred = false;
+
+	foreach(lc, stmt_list)
+	{
+		PlannedStmt *plannedstmt = lfirst_node(PlannedStmt, lc);
+		int			rtable_size = list_length(plannedstmt->rtable);
+		Bitmapset  *relids;
+
+		if (plannedstmt->commandType == CMD_UTILITY)
+			relids = NULL;
+		else if (can_defer && CanDeferPrunableLocks(plannedstmt))
+		{
+			relids = bms_copy(plannedstmt->unprunableRelids);
+			*deferred = true;
+		}
+		else if (rtable_size > 0)
+			relids = bms_add_range(NULL, 1, rtable_size);
+		else
+			relids = NULL;
+
+		result = lappend(result, relids);
+	}
+
+	return result;
+}
+
+/*
+ * LockInitialUnprunedRelids: lock the partitions of a cached plan that
+ * survive initial partition pruning.
+ *
+ * lock_relids is the list returned by GetExecutorLockRelids, whose locks
+ * must already be held.  The RT indexes of the relations we lock are added
+ * to it, so that AcquireExecutorLocks can release them again if needed.
+ *
+ * The executor repeats the same pruning during ExecutorStart, with the same
+ * parameter values.  CanDeferPrunableLocks made sure that it can't find any
+ * partition that we didn't; see also ExecGetInitialUnprunedRelids.
+ */
+static void
+LockInitialUnprunedRelids(List *stmt_list, List *lock_relids,
+						  ParamListInfo boundParams)
+{
+	ListCell   *lc1,
+			   *lc2;
+
+	forboth(lc1, stmt_list, lc2, lock_relids)
+	{
+		PlannedStmt *plannedstmt = lfirst_node(PlannedStmt, lc1);
+		Bitmapset  *relids = (Bitmapset *) lfirst(lc2);
+		Bitmapset  *unpruned_relids;
+		int			rti;
+
+		/* Only the statements GetExecutorLockRelids deferred locks for */
+		if (!CanDeferPrunableLocks(plannedstmt))
+			continue;
+
+		unpruned_relids = ExecGetInitialUnprunedRelids(plannedstmt,
+													   boundParams);
+
+		rti = -1;
+		while ((rti = bms_next_member(unpruned_relids, rti)) > 0)
+		{
+			RangeTblEntry *rte = rt_fetch(rti, plannedstmt->rtable);
+
+			Assert(rte->rtekind == RTE_RELATION);
+			LockRelationOid(rte->relid, rte->rellockmode);
+		}
+
+		lfirst(lc2) = bms_add_members(relids, unpruned_relids);
+	}
+}
+
 /*
  * AcquireExecutorLocks: acquire locks needed for execution of a cached plan;
  * or release them if acquire is false.
+ *
+ * lock_relids is a list parallel to stmt_list, giving the RT indexes of the
+ * relations to lock or unlock for each PlannedStmt; see
+ * GetExecutorLockRelids.
  */
 static void
-AcquireExecutorLocks(List *stmt_list, bool acquire)
+AcquireExecutorLocks(List *stmt_list, List *lock_relids, bool acquire)
 {
-	ListCell   *lc1;
+	ListCell   *lc1,
+			   *lc2;
 
-	foreach(lc1, stmt_list)
+	forboth(lc1, stmt_list, lc2, lock_relids)
 	{
 		PlannedStmt *plannedstmt = lfirst_node(PlannedStmt, lc1);
-		ListCell   *lc2;
+		Bitmapset  *relids = (Bitmapset *) lfirst(lc2);
+		int			rti;
 
 		if (plannedstmt->commandType == CMD_UTILITY)
 		{
@@ -1931,9 +2108,10 @@ AcquireExecutorLocks(List *stmt_list, bool acquire)
 			continue;
 		}
 
-		foreach(lc2, plannedstmt->rtable)
+		rti = -1;
+		while ((rti = bms_next_member(relids, rti)) > 0)
 		{
-			RangeTblEntry *rte = (RangeTblEntry *) lfirst(lc2);
+			RangeTblEntry *rte = rt_fetch(rti, plannedstmt->rtable);
 
 			if (!(rte->rtekind == RTE_RELATION ||
 				  (rte->rtekind == RTE_SUBQUERY && OidIsValid(rte->relid))))
@@ -24,6 +24,7 @@
 #include "catalog/pg_db_role_setting_d.h"
 #include "catalog/pg_depend_d.h"
 #include "catalog/pg_description_d.h"
+#include "catalog/pg_namespace_d.h"
 #include "catalog/pg_seclabel_d.h"
 #include "catalog/pg_shdepend_d.h"
 #include "catalog/pg_shdescription_d.h"
@@ -33,10 +34,12 @@
 #include "miscadmin.h"
 #include "storage/lmgr.h"
 #include "utils/catcache.h"
+#include "utils/guc_hooks.h"
 #include "utils/inval.h"
 #include "utils/lsyscache.h"
 #include "utils/rel.h"
 #include "utils/syscache.h"
+#include "utils/varlena.h"
 
 /*---------------------------------------------------------------------------
 
@@ -87,6 +90,9 @@ static CatCache *SysCache[SysCacheSize];
 
 static bool CacheInitialized = false;
 
+/* GUC parameter: catalogs whose caches are preloaded at backend start */
+char	   *catalog_cache_preload = NULL;
+
 /* Sorted array of OIDs of tables that have caches on them */
 static Oid	SysCacheRelationOid[SysCacheSize];
 static int	SysCacheRelationOidSize;
@@ -187,6 +193,90 @@ InitCatalogCachePhase2(void)
 		InitCatCachePhase2(SysCache[cacheId], true);
 }
 
+/*
+ * PreloadCatalogCaches - fill the caches named by catalog_cache_preload
+ *
+ * This is called at the end of backend startup, inside the startup
+ * transaction.  Each listed catalog is read with a single sequential scan
+ * per cache built on it, which is much cheaper than faulting in thousands
+ * of entries one at a time during the first queries of the session.
+ */
+void
+PreloadCatalogCaches(void)
+{
+	char	   *rawstring;
+	List	   *namelist;
+	ListCell   *lc;
+
+	Assert(CacheInitialized);
+
+	if (catalog_cache_preload == NULL || catalog_cache_preload[0] == '\0')
+		return;
+
+	/* Need a modifiable copy of string */
+	rawstring = pstrdup(catalog_cache_preload);
+
+	/* Parse string into list of identifiers; check_hook validated it */
+	if (!SplitIdentifierString(rawstring, ',', &namelist))
+		elog(ERROR, "invalid list syntax in parameter \"%s\"",
+			 "catalog_cache_preload");
+
+	foreach(lc, namelist)
+	{
+		char	   *relname = (char *) lfirst(lc);
+		Oid			reloid;
+		bool		found = false;
+
+		reloid = get_relname_relid(relname, PG_CATALOG_NAMESPACE);
+
+		for (int cacheId = 0; OidIsValid(reloid) && cacheId < SysCacheSize;
+			 cacheId++)
+		{
+			if (SysCache[cacheId]->cc_reloid != reloid)
+				continue;
+			PreloadCatCache(SysCache[cacheId]);
+			found = true;
+		}
+
+		if (!found)
+			ereport(WARNING,
+					(errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					 errmsg("\"%s\" is not a system catalog with a system cache",
+							relname)));
+	}
+
+	pfree(rawstring);
+	list_free(namelist);
+}
+
+/*
+ * GUC check_hook for catalog_cache_preload
+ */
+bool
+check_catalog_cache_preload(char **newval, void **extra, GucSource source)
+{
+	char	   *rawstring;
+	List	   *namelist;
+
+	/* Need a modifiable copy of string */
+	rawstring = pstrdup(*newval);
+
+	/* Parse string into list of identifiers */
+	if (!SplitIdentifierString(rawstring, ',', &namelist))
+	{
+		/* syntax error in name list */
+		GUC_check_errdetail("List syntax is invalid.");
+		pfree(rawstring);
+		list_free(namelist);
+		return false;
+	}
+
+	pfree(rawstring);
+	list_free(namelist);
+
+	return true;
+}
+
 
 /*
  * SearchSysCache
@@ -1225,6 +1225,14 @@ InitPostgres(const char *in_dbname, Oid dboid,
 	if ((flags & INIT_PG_LOAD_SESSION_LIBS) != 0)
 		process_session_preload_libraries();
 
+	/*
+	 * Likewise, warm up the catalog caches requested by
+	 * catalog_cache_preload, so that the first queries of the session don't
+	 * have to fault them in one entry at a time.
+	 */
+	if ((flags & INIT_PG_LOAD_SESSION_LIBS) != 0)
+		PreloadCatalogCaches();
+
 	/* fill in the remainder of this entry in the PgBackendStatus array */
 	if (!bootstrap)
 		pgstat_bestart_final();
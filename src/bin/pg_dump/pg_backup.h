@@ -181,6 +181,7 @@ typedef struct _dumpOptions
 	int			dump_inserts;	/* 0 = COPY, otherwise rows per INSERT */
 
 	/* flags for various command-line long options */
+	int			binary_copy;
 	int			disable_dollar_quoting;
 	int			column_inserts;
 	int			if_exists;
@@ -78,6 +78,7 @@ static bool _tocEntryIsACL(TocEntry *te);
 static void _disableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static void _enableTriggersIfNecessary(ArchiveHandle *AH, TocEntry *te);
 static bool is_load_via_partition_root(TocEntry *te);
+static bool is_binary_copy(TocEntry *te);
 static void buildTocEntryArrays(ArchiveHandle *AH);
 static void _moveBefore(TocEntry *pos, TocEntry *te);
 static int	_discoverArchiveFormat(ArchiveHandle *AH);
@@ -392,6 +393,21 @@ RestoreArchive(Archive *AHX)
 		}
 	}
 
+	/*
+	 * Binary COPY data can't be represented in a script, so check that there
+	 * is none before writing anything.
+	 */
+	if (!ropt->useDB)
+	{
+		for (te = AH->toc->next; te != AH->toc; te = te->next)
+		{
+			if (te->hadDumper && (te->reqs & REQ_DATA) != 0 &&
+				is_binary_copy(te))
+				pg_fatal("cannot restore binary data of table \"%s.%s\" into a script",
+						 te->namespace, te->tag);
+		}
+	}
+
 	/*
 	 * Prepare index arrays, so we can assume we have them throughout restore.
 	 * It's possible we already did this, though.
@@ -1211,6 +1227,25 @@ is_load_via_partition_root(TocEntry *te)
 	return false;
 }
 
+/*
+ * Was the TOC entry's data dumped in binary COPY format?
+ *
+ * pg_dump emits "COPY ... FROM stdin WITH (FORMAT binary);\n" as the COPY
+ * statement in that case, see dumpTableData().
+ */
+static bool
+is_binary_copy(TocEntry *te)
+{
+	const char *suffix = " FROM stdin WITH (FORMAT binary);\n";
+	size_t		len;
+
+	if (te->copyStmt == NULL)
+		return false;
+	len = strlen(te->copyStmt);
+	return len > strlen(suffix) &&
+		strcmp(te->copyStmt + len - strlen(suffix), suffix) == 0;
+}
+
 /*
  * This is a routine that is part of the dumper interface, hence the 'Archive*' parameter.
  */
@@ -2007,7 +2042,13 @@ buildTocEntryArrays(ArchiveHandle *AH)
 		 * TOC entry that has a DATA item.  We compute this by reversing the
 		 * TABLE DATA item's dependency, knowing that a TABLE DATA item has
 		 * just one dependency and it is the TABLE item.
+		 *
+		 * If the table's data was dumped in several chunks, tableDataId
+		 * gives the first one, and the others are chained to it through
+		 * nextTableData.  Archives older than K_VERS_1_17 have at most one
+		 * TABLE DATA item per table.
 		 */
+		te->nextTableData = NULL;
 		if (strcmp(te->desc, "TABLE DATA") == 0 && te->nDeps > 0)
 		{
 			DumpId		tableId = te->dependencies[0];
@@ -2020,7 +2061,18 @@ buildTocEntryArrays(ArchiveHandle *AH)
 			if (tableId <= 0 || tableId > maxDumpId)
 				pg_fatal("bad table dumpId for TABLE DATA item");
 
-			AH->tableDataId[tableId] = te->dumpId;
+			if (AH->tableDataId[tableId] == 0)
+				AH->tableDataId[tableId] = te->dumpId;
+			else if (AH->version < K_VERS_1_17)
+				pg_fatal("multiple TABLE DATA items for the same table");
+			else
+			{
+				TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[tableId]];
+
+				while (ted->nextTableData != NULL)
+					ted = ted->nextTableData;
+				ted->nextTableData = te;
+			}
 		}
 	}
 }
@@ -4978,9 +5030,11 @@ repoint_table_dependencies(ArchiveHandle *AH)
 
 	for (te = AH->toc->next; te != AH->toc; te = te->next)
 	{
+		int			nOrigDeps = te->nDeps;
+
 		if (te->section != SECTION_POST_DATA)
 			continue;
-		for (i = 0; i < te->nDeps; i++)
+		for (i = 0; i < nOrigDeps; i++)
 		{
 			olddep = te->dependencies[i];
 			if (olddep <= AH->maxDumpId &&
@@ -4988,11 +5042,34 @@ repoint_table_dependencies(ArchiveHandle *AH)
 			{
 				DumpId		tabledataid = AH->tableDataId[olddep];
 				TocEntry   *tabledatate = AH->tocsByDumpId[tabledataid];
+				pgoff_t		dataLength = 0;
 
 				te->dependencies[i] = tabledataid;
-				te->dataLength = Max(te->dataLength, tabledatate->dataLength);
 				pg_log_debug("transferring dependency %d -> %d to %d",
 							 te->dumpId, olddep, tabledataid);
+
+				/*
+				 * If the table's data was dumped in chunks, depend on all of
+				 * them, and count their total size.
+				 */
+				for (;;)
+				{
+					dataLength += tabledatate->dataLength;
+
+					tabledatate = tabledatate->nextTableData;
+					if (tabledatate == NULL)
+						break;
+
+					te->dependencies = (DumpId *)
+						pg_realloc(te->dependencies,
+								   sizeof(DumpId) * (te->nDeps + 1));
+					te->dependencies[te->nDeps++] = tabledatate->dumpId;
+					te->depCount++;
+					pg_log_debug("adding dependency %d -> %d",
+								 te->dumpId, tabledatate->dumpId);
+				}
+
+				te->dataLength = Max(te->dataLength, dataLength);
 			}
 		}
 	}
@@ -5106,6 +5183,10 @@ reduce_dependencies(ArchiveHandle *AH, TocEntry *te,
 /*
  * Set the created flag on the DATA member corresponding to the given
  * TABLE member
+ *
+ * The flag allows restoring the data with a TRUNCATE in the same
+ * transaction, which is not possible if the data was dumped in several
+ * chunks, so we don't set it then.
  */
 static void
 mark_create_done(ArchiveHandle *AH, TocEntry *te)
@@ -5114,12 +5195,13 @@ mark_create_done(ArchiveHandle *AH, TocEntry *te)
 	{
 		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
 
-		ted->created = true;
+		if (ted->nextTableData == NULL)
+			ted->created = true;
 	}
 }
 
 /*
- * Mark the DATA member corresponding to the given TABLE member
+ * Mark the DATA member(s) corresponding to the given TABLE member
  * as not wanted
  */
 static void
@@ -5130,9 +5212,11 @@ inhibit_data_for_failed_table(ArchiveHandle *AH, TocEntry *te)
 
 	if (AH->tableDataId[te->dumpId] != 0)
 	{
-		TocEntry   *ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+		TocEntry   *ted;
 
-		ted->reqs = 0;
+		for (ted = AH->tocsByDumpId[AH->tableDataId[te->dumpId]];
+			 ted != NULL; ted = ted->nextTableData)
+			ted->reqs = 0;
 	}
 }
 
@@ -153,6 +153,9 @@ static bool dosync = true;		/* Issue fsync() to make dump durable on disk. */
 
 static Oid	g_last_builtin_oid; /* value of the last builtin oid */
 
+/* Split the data of tables larger than this many pages into chunks */
+static BlockNumber table_chunk_pages = 0;
+
 /* The specified names/patterns should to match at least one entity */
 static int	strict_names = 0;
 
@@ -268,6 +271,7 @@ static void prohibit_crossdb_refs(PGconn *conn, const char *dbname,
 								  const char *pattern);
 
 static NamespaceInfo *findNamespace(Oid nsoid);
+static bool useBinaryCopy(Archive *fout, const TableInfo *tbinfo);
 static void dumpTableData(Archive *fout, const TableDataInfo *tdinfo);
 static void refreshMatViewData(Archive *fout, const TableDataInfo *tdinfo);
 static const char *getRoleName(const char *roleoid_str);
@@ -440,6 +444,7 @@ main(int argc, char **argv)
 	const char *dumpsnapshot = NULL;
 	char	   *use_role = NULL;
 	int			numWorkers = 1;
+	int			table_chunk_size = 0;
 	int			plainText = 0;
 	ArchiveFormat archiveFormat = archUnknown;
 	ArchiveMode archiveMode;
@@ -497,6 +502,7 @@ main(int argc, char **argv)
 		 * the following options don't have an equivalent short option letter
 		 */
 		{"attribute-inserts", no_argument, &dopt.column_inserts, 1},
+		{"binary-copy", no_argument, &dopt.binary_copy, 1},
 		{"binary-upgrade", no_argument, &dopt.binary_upgrade, 1},
 		{"column-inserts", no_argument, &dopt.column_inserts, 1},
 		{"disable-dollar-quoting", no_argument, &dopt.disable_dollar_quoting, 1},
@@ -541,6 +547,7 @@ main(int argc, char **argv)
 		{"exclude-extension", required_argument, NULL, 17},
 		{"sequence-data", no_argument, &dopt.sequence_data, 1},
 		{"restrict-key", required_argument, NULL, 25},
+		{"table-chunk-size", required_argument, NULL, 26},
 
 		{NULL, 0, NULL, 0}
 	};
@@ -805,6 +812,12 @@ main(int argc, char **argv)
 				dopt.restrict_key = pg_strdup(optarg);
 				break;
 
+			case 26:			/* table chunk size */
+				if (!option_parse_int(optarg, "--table-chunk-size", 1, INT_MAX,
+									  &table_chunk_size))
+					exit_nicely(1);
+				break;
+
 			default:
 				/* getopt_long already emitted a complaint */
 				pg_log_error_hint("Try \"%s --help\" for more information.", progname);
@@ -905,9 +918,22 @@ main(int argc, char **argv)
 				 "--on-conflict-do-nothing",
 				 "--inserts", "--rows-per-insert", "--column-inserts");
 
+	if (dopt.binary_copy && dopt.dump_inserts != 0)
+		pg_fatal("options %s and %s cannot be used together",
+				 "--binary-copy", "--inserts");
+
 	/* Identify archive format to emit */
 	archiveFormat = parseArchiveFormat(format, &archiveMode);
 
+	/*
+	 * Binary COPY data can't be loaded by psql scripts, so allow it only in
+	 * the archive formats that pg_restore loads directly.
+	 */
+	if (dopt.binary_copy &&
+		archiveFormat != archCustom && archiveFormat != archDirectory)
+		pg_fatal("option %s is only supported by the custom and directory formats",
+				 "--binary-copy");
+
 	/* archiveFormat specific setup */
 	if (archiveFormat == archNull)
 	{
@@ -1018,6 +1044,31 @@ main(int argc, char **argv)
 	if (fout->isStandby)
 		dopt.no_unlogged_table_data = true;
 
+	/*
+	 * Translate --table-chunk-size from megabytes into pages.  Dumping a
+	 * chunk of a table is only efficient with TID range scans, which appeared
+	 * in v14.
+	 */
+	if (table_chunk_size > 0)
+	{
+		if (fout->remoteVersion < 140000)
+			pg_log_warning("option %s is ignored for server versions older than %s",
+						   "--table-chunk-size", "14");
+		else
+		{
+			PGresult   *res;
+			uint64		chunk_pages;
+
+			res = ExecuteSqlQueryForSingleRow(fout,
+											  "SELECT pg_catalog.current_setting('block_size')");
+			chunk_pages = (uint64) table_chunk_size * 1024 * 1024 /
+				atoi(PQgetvalue(res, 0, 0));
+			table_chunk_pages = (BlockNumber) Min(Max(chunk_pages, 1),
+												  MaxBlockNumber);
+			PQclear(res);
+		}
+	}
+
 	/*
 	 * Find the last built-in OID, if needed (prior to 8.1)
 	 *
@@ -1357,6 +1408,7 @@ help(const char *progname)
 	printf(_("  -t, --table=PATTERN          dump only the specified table(s)\n"));
 	printf(_("  -T, --exclude-table=PATTERN  do NOT dump the specified table(s)\n"));
 	printf(_("  -x, --no-privileges          do not dump privileges (grant/revoke)\n"));
+	printf(_("  --binary-copy                dump data in binary COPY format\n"));
 	printf(_("  --binary-upgrade             for use by upgrade utilities only\n"));
 	printf(_("  --column-inserts             dump data as INSERT commands with column names\n"));
 	printf(_("  --disable-dollar-quoting     disable dollar quoting, use SQL standard quoting\n"));
@@ -1406,6 +1458,8 @@ help(const char *progname)
 			 "                               match at least one entity each\n"));
 	printf(_("  --table-and-children=PATTERN dump only the specified table(s), including\n"
 			 "                               child and partition tables\n"));
+	printf(_("  --table-chunk-size=SIZE      dump data of tables larger than SIZE megabytes\n"
+			 "                               in separate chunks of that size\n"));
 	printf(_("  --use-set-session-authorization\n"
 			 "                               use SET SESSION AUTHORIZATION commands instead of\n"
 			 "                               ALTER OWNER commands to set ownership\n"));
@@ -2385,6 +2439,18 @@ selectDumpableObject(DumpableObject *dobj, Archive *fout)
 			DUMP_COMPONENT_ALL : DUMP_COMPONENT_NONE;
 }
 
+/*
+ * Should the table's data be dumped in binary COPY format?
+ *
+ * We fall back to text format for tables with a column of a type whose
+ * binary format is unavailable or not portable; see getTableAttrs().
+ */
+static bool
+useBinaryCopy(Archive *fout, const TableInfo *tbinfo)
+{
+	return fout->dopt->binary_copy && tbinfo->hasbinaryio;
+}
+
 /*
  *	Dump a table's contents for loading using the COPY command
  *	- this routine is called by the Archiver when it wants the table
@@ -2408,6 +2474,8 @@ dumpTableData_copy(Archive *fout, const void *dcontext)
 	int			ret;
 	char	   *copybuf;
 	const char *column_list;
+	bool		binary = useBinaryCopy(fout, tbinfo);
+	const char *copyopts = binary ? " WITH (FORMAT binary)" : "";
 
 	pg_log_info("dumping contents of table \"%s.%s\"",
 				tbinfo->dobj.namespace->dobj.name, classname);
@@ -2421,11 +2489,27 @@ dumpTableData_copy(Archive *fout, const void *dcontext)
 	column_list = fmtCopyColumnList(tbinfo, clistBuf);
 
 	/*
-	 * Use COPY (SELECT ...) TO when dumping a foreign table's data, and when
-	 * a filter condition was specified.  For other cases a simple COPY
-	 * suffices.
+	 * Use COPY (SELECT ...) TO when dumping a foreign table's data, when a
+	 * filter condition was specified, and when dumping a chunk of the table.
+	 * For other cases a simple COPY suffices.
 	 */
-	if (tdinfo->filtercond || tbinfo->relkind == RELKIND_FOREIGN_TABLE)
+	if (tdinfo->chunkcond)
+	{
+		appendPQExpBufferStr(q, "COPY (SELECT ");
+		/* klugery to get rid of parens in column list */
+		if (strlen(column_list) > 2)
+		{
+			appendPQExpBufferStr(q, column_list + 1);
+			q->data[q->len - 1] = ' ';
+		}
+		else
+			appendPQExpBufferStr(q, "* ");
+
+		appendPQExpBuffer(q, "FROM ONLY %s %s) TO stdout%s;",
+						  fmtQualifiedDumpable(tbinfo),
+						  tdinfo->chunkcond, copyopts);
+	}
+	else if (tdinfo->filtercond || tbinfo->relkind == RELKIND_FOREIGN_TABLE)
 	{
 		/* Temporary allows to access to foreign tables to dump data */
 		if (tbinfo->relkind == RELKIND_FOREIGN_TABLE)
@@ -2441,15 +2525,16 @@ dumpTableData_copy(Archive *fout, const void *dcontext)
 		else
 			appendPQExpBufferStr(q, "* ");
 
-		appendPQExpBuffer(q, "FROM %s %s) TO stdout;",
+		appendPQExpBuffer(q, "FROM %s %s) TO stdout%s;",
 						  fmtQualifiedDumpable(tbinfo),
-						  tdinfo->filtercond ? tdinfo->filtercond : "");
+						  tdinfo->filtercond ? tdinfo->filtercond : "",
+						  copyopts);
 	}
 	else
 	{
-		appendPQExpBuffer(q, "COPY %s %s TO stdout;",
+		appendPQExpBuffer(q, "COPY %s %s TO stdout%s;",
 						  fmtQualifiedDumpable(tbinfo),
-						  column_list);
+						  column_list, copyopts);
 	}
 	res = ExecuteSqlQuery(fout, q->data, PGRES_COPY_OUT);
 	PQclear(res);
@@ -2514,7 +2599,10 @@ dumpTableData_copy(Archive *fout, const void *dcontext)
 		 * ----------
 		 */
 	}
-	archprintf(fout, "\\.\n\n\n");
+
+	/* Binary COPY data carries its own end marker */
+	if (!binary)
+		archprintf(fout, "\\.\n\n\n");
 
 	if (ret == -2)
 	{
@@ -2609,6 +2697,8 @@ dumpTableData_insert(Archive *fout, const void *dcontext)
 					  fmtQualifiedDumpable(tbinfo));
 	if (tdinfo->filtercond)
 		appendPQExpBuffer(q, " %s", tdinfo->filtercond);
+	else if (tdinfo->chunkcond)
+		appendPQExpBuffer(q, " %s", tdinfo->chunkcond);
 
 	ExecuteSqlStatement(fout, q->data);
 
@@ -2926,8 +3016,9 @@ dumpTableData(Archive *fout, const TableDataInfo *tdinfo)
 		/* must use 2 steps here 'cause fmtId is nonreentrant */
 		printfPQExpBuffer(copyBuf, "COPY %s ",
 						  copyFrom);
-		appendPQExpBuffer(copyBuf, "%s FROM stdin;\n",
-						  fmtCopyColumnList(tbinfo, clistBuf));
+		appendPQExpBuffer(copyBuf, "%s FROM stdin%s;\n",
+						  fmtCopyColumnList(tbinfo, clistBuf),
+						  useBinaryCopy(fout, tbinfo) ? " WITH (FORMAT binary)" : "");
 		copyStmt = copyBuf->data;
 	}
 	else
@@ -2944,44 +3035,107 @@ dumpTableData(Archive *fout, const TableDataInfo *tdinfo)
 	 */
 	if (tdinfo->dobj.dump & DUMP_COMPONENT_DATA)
 	{
-		TocEntry   *te;
-
-		te = ArchiveEntry(fout, tdinfo->dobj.catId, tdinfo->dobj.dumpId,
-						  ARCHIVE_OPTS(.tag = tbinfo->dobj.name,
-									   .namespace = tbinfo->dobj.namespace->dobj.name,
-									   .owner = tbinfo->rolname,
-									   .description = "TABLE DATA",
-									   .section = SECTION_DATA,
-									   .createStmt = tdDefn,
-									   .copyStmt = copyStmt,
-									   .deps = &(tbinfo->dobj.dumpId),
-									   .nDeps = 1,
-									   .dumpFn = dumpFn,
-									   .dumpArg = tdinfo));
+		BlockNumber relpages = (BlockNumber) tbinfo->relpages;
+		BlockNumber nchunks = 1;
+		BlockNumber chunk;
 
 		/*
-		 * Set the TocEntry's dataLength in case we are doing a parallel dump
-		 * and want to order dump jobs by table size.  We choose to measure
-		 * dataLength in table pages (including TOAST pages) during dump, so
-		 * no scaling is needed.
-		 *
-		 * However, relpages is declared as "integer" in pg_class, and hence
-		 * also in TableInfo, but it's really BlockNumber a/k/a unsigned int.
-		 * Cast so that we get the right interpretation of table sizes
-		 * exceeding INT_MAX pages.
+		 * If requested, split the data of a large table into chunks of
+		 * consecutive pages, each in a TABLE DATA item of its own, so that
+		 * parallel dump and restore can process them concurrently.  The
+		 * chunks are delimited by ctid ranges, which the server can scan
+		 * efficiently with a TID Range Scan.  relpages is only an estimate,
+		 * so the last chunk is left open-ended.  We don't bother with tables
+		 * having a filter condition, or using another table access method
+		 * than heap, whose notion of ctid might differ.
 		 */
-		te->dataLength = (BlockNumber) tbinfo->relpages;
-		te->dataLength += (BlockNumber) tbinfo->toastpages;
+		if (table_chunk_pages > 0 &&
+			tbinfo->relkind == RELKIND_RELATION &&
+			tdinfo->filtercond == NULL &&
+			(tbinfo->amname == NULL || strcmp(tbinfo->amname, "heap") == 0) &&
+			relpages > table_chunk_pages)
+			nchunks = (relpages + table_chunk_pages - 1) / table_chunk_pages;
+
+		for (chunk = 0; chunk < nchunks; chunk++)
+		{
+			const TableDataInfo *chunkinfo = tdinfo;
+			DumpId		dumpId = tdinfo->dobj.dumpId;
+			TocEntry   *te;
 
-		/*
-		 * If pgoff_t is only 32 bits wide, the above refinement is useless,
-		 * and instead we'd better worry about integer overflow.  Clamp to
-		 * INT_MAX if the correct result exceeds that.
-		 */
-		if (sizeof(te->dataLength) == 4 &&
-			(tbinfo->relpages < 0 || tbinfo->toastpages < 0 ||
-			 te->dataLength < 0))
-			te->dataLength = INT_MAX;
+			if (nchunks > 1)
+			{
+				TableDataInfo *cinfo = (TableDataInfo *) pg_malloc(sizeof(TableDataInfo));
+				BlockNumber startpage = chunk * table_chunk_pages;
+
+				*cinfo = *tdinfo;
+				if (chunk == 0)
+					cinfo->chunkcond = psprintf("WHERE ctid < '(%u,0)'",
+												table_chunk_pages);
+				else if (chunk < nchunks - 1)
+					cinfo->chunkcond = psprintf("WHERE ctid >= '(%u,0)' AND ctid < '(%u,0)'",
+												startpage,
+												startpage + table_chunk_pages);
+				else
+					cinfo->chunkcond = psprintf("WHERE ctid >= '(%u,0)'",
+												startpage);
+				chunkinfo = cinfo;
+
+				/* The first chunk takes the place of the whole table */
+				if (chunk > 0)
+					dumpId = createDumpId();
+			}
+
+			te = ArchiveEntry(fout, tdinfo->dobj.catId, dumpId,
+							  ARCHIVE_OPTS(.tag = tbinfo->dobj.name,
+										   .namespace = tbinfo->dobj.namespace->dobj.name,
+										   .owner = tbinfo->rolname,
+										   .description = "TABLE DATA",
+										   .section = SECTION_DATA,
+										   .createStmt = tdDefn,
+										   .copyStmt = copyStmt,
+										   .deps = &(tbinfo->dobj.dumpId),
+										   .nDeps = 1,
+										   .dumpFn = dumpFn,
+										   .dumpArg = chunkinfo));
+
+			/*
+			 * Set the TocEntry's dataLength in case we are doing a parallel
+			 * dump and want to order dump jobs by table size.  We choose to
+			 * measure dataLength in table pages (including TOAST pages)
+			 * during dump, so no scaling is needed.
+			 *
+			 * However, relpages is declared as "integer" in pg_class, and
+			 * hence also in TableInfo, but it's really BlockNumber a/k/a
+			 * unsigned int.  Cast so that we get the right interpretation of
+			 * table sizes exceeding INT_MAX pages.
+			 *
+			 * For a chunk, count its share of the table's pages.
+			 */
+			if (nchunks > 1)
+			{
+				BlockNumber chunkpages = Min(table_chunk_pages,
+											 relpages - chunk * table_chunk_pages);
+
+				te->dataLength = chunkpages;
+				te->dataLength += (pgoff_t) ((double) (BlockNumber) tbinfo->toastpages *
+											 chunkpages / relpages);
+			}
+			else
+			{
+				te->dataLength = (BlockNumber) tbinfo->relpages;
+				te->dataLength += (BlockNumber) tbinfo->toastpages;
+			}
+
+			/*
+			 * If pgoff_t is only 32 bits wide, the above refinement is
+			 * useless, and instead we'd better worry about integer overflow.
+			 * Clamp to INT_MAX if the correct result exceeds that.
+			 */
+			if (sizeof(te->dataLength) == 4 &&
+				(tbinfo->relpages < 0 || tbinfo->toastpages < 0 ||
+				 te->dataLength < 0))
+				te->dataLength = INT_MAX;
+		}
 	}
 
 	destroyPQExpBuffer(copyBuf);
@@ -3105,6 +3259,7 @@ makeTableDataInfo(DumpOptions *dopt, TableInfo *tbinfo)
 	tdinfo->dobj.namespace = tbinfo->dobj.namespace;
 	tdinfo->tdtable = tbinfo;
 	tdinfo->filtercond = NULL;	/* might get set later */
+	tdinfo->chunkcond = NULL;
 	addObjectDependency(&tdinfo->dobj, tbinfo->dobj.dumpId);
 
 	/* A TableDataInfo contains data, of course */
@@ -9262,6 +9417,7 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 	int			i_attnum;
 	int			i_attname;
 	int			i_atttypname;
+	int			i_atthasbinaryio;
 	int			i_attstattarget;
 	int			i_attstorage;
 	int			i_typstorage;
@@ -9341,6 +9497,15 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 	 * Since we only want to dump COLLATE clauses for attributes whose
 	 * collation is different from their type's default, we use a CASE here to
 	 * suppress uninteresting attcollations cheaply.
+	 *
+	 * atthasbinaryio tells whether the column can be dumped with binary COPY.
+	 * That requires binary I/O functions for the type and, for a domain, for
+	 * all of its base types.  The binary format of arrays and composites
+	 * contains the OIDs of their element or field types, which differ in the
+	 * database restored into, and that of ranges and multiranges relies on
+	 * their subtype's, so we don't use it for any of those, even under a
+	 * domain.  Without --binary-copy the answer isn't needed, so we save the
+	 * server the trouble of working it out.
 	 */
 	appendPQExpBufferStr(q,
 						 "SELECT\n"
@@ -9355,7 +9520,26 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 						 "a.attlen,\n"
 						 "a.attalign,\n"
 						 "a.attislocal,\n"
-						 "pg_catalog.format_type(t.oid, a.atttypmod) AS atttypname,\n"
+						 "pg_catalog.format_type(t.oid, a.atttypmod) AS atttypname,\n");
+
+	if (dopt->binary_copy)
+		appendPQExpBufferStr(q,
+							 "NOT EXISTS (WITH RECURSIVE bt(oid) AS ("
+							 "SELECT a.atttypid UNION ALL "
+							 "SELECT d.typbasetype FROM pg_catalog.pg_type d "
+							 "JOIN bt ON (d.oid = bt.oid) WHERE d.typtype = 'd') "
+							 "SELECT 1 FROM bt JOIN pg_catalog.pg_type bt_t "
+							 "ON (bt_t.oid = bt.oid) "
+							 "WHERE bt_t.typsend::pg_catalog.oid = 0 "
+							 "OR bt_t.typreceive::pg_catalog.oid = 0 "
+							 "OR bt_t.typtype IN ('c', 'r', 'm') "
+							 "OR (bt_t.typelem <> 0 AND bt_t.typlen = -1)"
+							 ") AS atthasbinaryio,\n");
+	else
+		appendPQExpBufferStr(q,
+							 "true AS atthasbinaryio,\n");
+
+	appendPQExpBufferStr(q,
 						 "array_to_string(a.attoptions, ', ') AS attoptions,\n"
 						 "CASE WHEN a.attcollation <> t.typcollation "
 						 "THEN a.attcollation ELSE 0 END AS attcollation,\n"
@@ -9466,6 +9650,7 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 	i_attnum = PQfnumber(res, "attnum");
 	i_attname = PQfnumber(res, "attname");
 	i_atttypname = PQfnumber(res, "atttypname");
+	i_atthasbinaryio = PQfnumber(res, "atthasbinaryio");
 	i_attstattarget = PQfnumber(res, "attstattarget");
 	i_attstorage = PQfnumber(res, "attstorage");
 	i_typstorage = PQfnumber(res, "typstorage");
@@ -9553,6 +9738,7 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 		tbinfo->notnull_noinh = (bool *) pg_malloc(numatts * sizeof(bool));
 		tbinfo->notnull_islocal = (bool *) pg_malloc(numatts * sizeof(bool));
 		tbinfo->attrdefs = (AttrDefInfo **) pg_malloc(numatts * sizeof(AttrDefInfo *));
+		tbinfo->hasbinaryio = true;
 		hasdefaults = false;
 
 		for (int j = 0; j < numatts; j++, r++)
@@ -9575,6 +9761,9 @@ getTableAttrs(Archive *fout, TableInfo *tblinfo, int numTables)
 			tbinfo->attlen[j] = atoi(PQgetvalue(res, r, i_attlen));
 			tbinfo->attalign[j] = *(PQgetvalue(res, r, i_attalign));
 			tbinfo->attislocal[j] = (PQgetvalue(res, r, i_attislocal)[0] == 't');
+			if (!tbinfo->attisdropped[j] && !tbinfo->attgenerated[j] &&
+				PQgetvalue(res, r, i_atthasbinaryio)[0] != 't')
+				tbinfo->hasbinaryio = false;
 
 			/* Handle not-null constraint name and flags */
 			determineNotNullFlags(fout, res, r,
@@ -17923,6 +18112,9 @@ dumpTableSchema(Archive *fout, const TableInfo *tbinfo)
 					case 'l':
 						cmname = "lz4";
 						break;
+					case 'z':
+						cmname = "zstd";
+						break;
 					default:
 						cmname = NULL;
 						break;
@@ -380,6 +380,7 @@ typedef struct _tableInfo
 	struct _constraintInfo *checkexprs; /* CHECK constraints */
 	struct _relStatsInfo *stats;	/* only set for matviews */
 	bool		needs_override; /* has GENERATED ALWAYS AS IDENTITY */
+	bool		hasbinaryio;	/* all dumped columns' types have binary I/O */
 	char	   *amname;			/* relation access method */
 
 	/*
@@ -413,6 +414,8 @@ typedef struct _tableDataInfo
 	DumpableObject dobj;
 	TableInfo  *tdtable;		/* link to table to dump */
 	char	   *filtercond;		/* WHERE condition to limit rows dumped */
+	char	   *chunkcond;		/* WHERE condition selecting a chunk of the
+								 * table, if it is dumped in chunks */
 } TableDataInfo;
 
 typedef struct _indxInfo
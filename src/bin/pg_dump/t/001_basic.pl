@@ -207,6 +207,17 @@ command_fails_like(
 	'pg_dump: --on-conflict-do-nothing requires --inserts, --rows-per-insert, --column-inserts'
 );
 
+command_fails_like(
+	[ 'pg_dump', '--binary-copy', '--inserts' ],
+	qr/\Qpg_dump: error: options --binary-copy and --inserts cannot be used together\E/,
+	'pg_dump: options --binary-copy and --inserts cannot be used together');
+
+command_fails_like(
+	[ 'pg_dump', '--binary-copy', '--format' => 'plain' ],
+	qr/\Qpg_dump: error: option --binary-copy is only supported by the custom and directory formats\E/,
+	'pg_dump: option --binary-copy is only supported by the custom and directory formats'
+);
+
 # pg_dumpall command-line argument checks
 command_fails_like(
 	[ 'pg_dumpall', '-g', '-r' ],
@@ -11,6 +11,8 @@ use Test::More;
 my $dbname1 = 'regression_src';
 my $dbname2 = 'regression_dest1';
 my $dbname3 = 'regression_dest2';
+my $dbname4 = 'regression_dest3';
+my $dbname5 = 'regression_dest4';
 
 my $node = PostgreSQL::Test::Cluster->new('main');
 $node->init;
@@ -21,6 +23,8 @@ my $backupdir = $node->backup_dir;
 $node->run_log([ 'createdb', $dbname1 ]);
 $node->run_log([ 'createdb', $dbname2 ]);
 $node->run_log([ 'createdb', $dbname3 ]);
+$node->run_log([ 'createdb', $dbname4 ]);
+$node->run_log([ 'createdb', $dbname5 ]);
 
 $node->safe_psql(
 	$dbname1,
@@ -44,6 +48,18 @@ create table tht_p1 partition of tht for values with (modulus 3, remainder 0);
 create table tht_p2 partition of tht for values with (modulus 3, remainder 1);
 create table tht_p3 partition of tht for values with (modulus 3, remainder 2);
 insert into tht select (x%10)::text::digit, x from generate_series(1,1000) x;
+
+-- table big enough to be dumped in chunks
+create table tbig (id int primary key, data text);
+insert into tbig select x, repeat('x', 100) from generate_series(1,50000) x;
+vacuum analyze tbig;
+
+-- table whose binary format would contain type OIDs
+create type digitpair as (a digit, b digit);
+create table tnested (id int, digits digit[], pair digitpair);
+insert into tnested select x, array[(x%10)::text::digit],
+  row((x%10)::text::digit, ((x+1)%10)::text::digit)
+  from generate_series(1,100) x;
 	});
 
 $node->command_ok(
@@ -87,4 +103,77 @@ $node->command_ok(
 	],
 	'parallel restore as inserts');
 
+$node->command_ok(
+	[
+		'pg_dump',
+		'--format' => 'directory',
+		'--no-sync',
+		'--jobs' => 2,
+		'--file' => "$backupdir/dump3",
+		'--table-chunk-size' => 1,
+		$node->connstr($dbname1),
+	],
+	'parallel dump with table chunks');
+
+$node->command_ok(
+	[
+		'pg_restore', '--verbose',
+		'--dbname' => $node->connstr($dbname4),
+		'--jobs' => 3,
+		"$backupdir/dump3",
+	],
+	'parallel restore with table chunks');
+
+my ($toc) = run_command([ 'pg_restore', '--list', "$backupdir/dump3" ]);
+my $nchunks = () = $toc =~ /TABLE DATA public tbig /g;
+cmp_ok($nchunks, '>', 1, 'table was dumped in several chunks');
+
+is( $node->safe_psql($dbname4, 'select count(*), sum(id) from tbig'),
+	$node->safe_psql($dbname1, 'select count(*), sum(id) from tbig'),
+	'table restored from chunks has the same contents');
+
+$node->command_ok(
+	[
+		'pg_dump',
+		'--format' => 'directory',
+		'--no-sync',
+		'--jobs' => 2,
+		'--file' => "$backupdir/dump4",
+		'--binary-copy',
+		$node->connstr($dbname1),
+	],
+	'parallel dump in binary format');
+
+$node->command_ok(
+	[
+		'pg_restore', '--verbose',
+		'--dbname' => $node->connstr($dbname5),
+		'--jobs' => 3,
+		"$backupdir/dump4",
+	],
+	'parallel restore in binary format');
+
+is( $node->safe_psql(
+		$dbname5, 'select count(*), sum(data), max(en) from tplain'),
+	$node->safe_psql(
+		$dbname1, 'select count(*), sum(data), max(en) from tplain'),
+	'table restored from binary format has the same contents');
+
+is( $node->safe_psql(
+		$dbname5,
+		q{select string_agg(format('%s %s', digits, pair), ',' order by id)
+		  from tnested}),
+	$node->safe_psql(
+		$dbname1,
+		q{select string_agg(format('%s %s', digits, pair), ',' order by id)
+		  from tnested}),
+	'table with array and composite columns restored in text format');
+
+$node->command_fails_like(
+	[ 'pg_restore', '--file' => "$backupdir/dump4.sql", "$backupdir/dump4" ],
+	qr/cannot restore binary data of table/,
+	'binary data cannot be restored into a script');
+ok(!-e "$backupdir/dump4.sql",
+	'script is not written when the archive has binary data');
+
 done_testing();
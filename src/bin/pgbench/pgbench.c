@@ -268,6 +268,7 @@ static bool is_connect;			/* establish connection for each transaction */
 static bool report_per_command = false; /* report per-command latencies,
 										 * retries after errors and failures
 										 * (errors without retrying) */
+static bool report_percentiles = false; /* report latency percentiles */
 static int	main_pid;			/* main process id used in log filename */
 
 /*
@@ -364,6 +365,32 @@ typedef struct SimpleStats
 	double		sum2;			/* sum of squared values */
 } SimpleStats;
 
+/*
+ * Histogram of latencies in microseconds, used to report percentiles.
+ *
+ * Latencies below LATENCY_HIST_SUB_BUCKETS get a bucket of their own.  Above
+ * that, each power of two is split into LATENCY_HIST_SUB_BUCKETS / 2 buckets
+ * of equal width, so the width of a bucket is never more than 1/128th of the
+ * values it holds, whatever their magnitude.  Values of 2^LATENCY_HIST_BITS
+ * microseconds (about 51 days) or more all go into the last bucket.
+ */
+#define LATENCY_HIST_SUB_BITS		8
+#define LATENCY_HIST_SUB_BUCKETS	(1 << LATENCY_HIST_SUB_BITS)
+#define LATENCY_HIST_BITS			42
+#define LATENCY_HIST_BUCKETS \
+	((LATENCY_HIST_BITS - LATENCY_HIST_SUB_BITS) * (LATENCY_HIST_SUB_BUCKETS / 2) + \
+	 LATENCY_HIST_SUB_BUCKETS)
+
+typedef struct LatencyHistogram
+{
+	int64		count;			/* how many values were encountered */
+	int64		max;			/* the maximum seen */
+	int64		buckets[LATENCY_HIST_BUCKETS];
+} LatencyHistogram;
+
+/* Percentiles reported under --report-percentiles */
+static const double latency_percentiles[] = {50.0, 90.0, 99.0, 99.9};
+
 /*
  * The instr_time type is expensive when dealing with time arithmetic.  Define
  * a type to hold microseconds instead.  Type int64 is good enough for about
@@ -678,6 +705,11 @@ typedef struct
 									 * delays */
 
 	StatsData	stats;
+	LatencyHistogram *latency_hist; /* histogram of latencies, or NULL */
+	LatencyHistogram *script_hist;	/* histograms of latencies per script, or
+									 * NULL */
+	LatencyHistogram **command_hist;	/* per script, histograms of latencies
+										 * per command, or NULL */
 	int64		latency_late;	/* count executed but late transactions */
 } TState;
 
@@ -742,6 +774,9 @@ static const char *const QUERYMODE[] = {"simple", "extended", "prepared"};
  * aset			do gset on all possible queries of a combined query (\;).
  * expr			Parsed expression, if needed.
  * stats		Time spent in this command.
+ * latency_hist	Histogram of the time spent in this command, merged from the
+ *				threads' histograms at the end, or NULL if percentiles are
+ *				not reported.
  * retries		Number of retries after a serialization or deadlock error in the
  *				current command.
  * failures		Number of errors in the current command that were not retried.
@@ -758,6 +793,7 @@ typedef struct Command
 	char	   *varprefix;
 	PgBenchExpr *expr;
 	SimpleStats stats;
+	LatencyHistogram *latency_hist;
 	int64		retries;
 	int64		failures;
 } Command;
@@ -768,6 +804,8 @@ typedef struct ParsedScript
 	int			weight;			/* selection weight */
 	Command   **commands;		/* NULL-terminated array of Commands */
 	StatsData	stats;			/* total time spent in script */
+	LatencyHistogram *latency_hist; /* histogram of script latencies, merged
+									 * from the threads' at the end, or NULL */
 } ParsedScript;
 
 static ParsedScript sql_script[MAX_SCRIPTS];	/* SQL script files */
@@ -965,6 +1003,7 @@ usage(void)
 		   "  --max-tries=NUM          max number of tries to run transaction (default: 1)\n"
 		   "  --progress-timestamp     use Unix epoch timestamps for progress\n"
 		   "  --random-seed=SEED       set random seed (\"time\", \"rand\", integer)\n"
+		   "  --report-percentiles     report latency percentiles\n"
 		   "  --sampling-rate=NUM      fraction of transactions to log (e.g., 0.01 for 1%%)\n"
 		   "  --show-script=NAME       show builtin script code, then exit\n"
 		   "  --verbose-errors         print messages of all errors\n"
@@ -1417,6 +1456,91 @@ mergeSimpleStats(SimpleStats *acc, SimpleStats *ss)
 	acc->sum2 += ss->sum2;
 }
 
+/*
+ * Allocate a LatencyHistogram with no values
+ */
+static LatencyHistogram *
+createLatencyHistogram(void)
+{
+	return (LatencyHistogram *) pg_malloc0(sizeof(LatencyHistogram));
+}
+
+/*
+ * Accumulate one value, in microseconds, into a LatencyHistogram.
+ */
+static void
+addToLatencyHistogram(LatencyHistogram *hist, double val)
+{
+	uint64		v = (val > 0) ? (uint64) val : 0;
+	int			idx;
+
+	if (v < LATENCY_HIST_SUB_BUCKETS)
+		idx = v;
+	else
+	{
+		int			shift = pg_leftmost_one_pos64(v) - LATENCY_HIST_SUB_BITS + 1;
+
+		idx = shift * (LATENCY_HIST_SUB_BUCKETS / 2) + (v >> shift);
+		if (idx >= LATENCY_HIST_BUCKETS)
+			idx = LATENCY_HIST_BUCKETS - 1;
+	}
+
+	if (hist->count == 0 || v > hist->max)
+		hist->max = v;
+	hist->count++;
+	hist->buckets[idx]++;
+}
+
+/*
+ * Merge two LatencyHistogram objects
+ */
+static void
+mergeLatencyHistogram(LatencyHistogram *acc, LatencyHistogram *hist)
+{
+	if (acc->count == 0 || hist->max > acc->max)
+		acc->max = hist->max;
+	acc->count += hist->count;
+	for (int i = 0; i < LATENCY_HIST_BUCKETS; i++)
+		acc->buckets[i] += hist->buckets[i];
+}
+
+/*
+ * Return the given percentile of the values in a LatencyHistogram, in
+ * microseconds.  The result is the largest value that falls into the same
+ * bucket as the exact percentile, but never more than the maximum seen.
+ */
+static int64
+getLatencyPercentile(LatencyHistogram *hist, double percentile)
+{
+	int64		rank;
+	int64		seen = 0;
+	int			idx;
+
+	if (hist->count == 0)
+		return 0;
+
+	rank = (int64) ceil(percentile / 100.0 * hist->count);
+	if (rank < 1)
+		rank = 1;
+
+	for (idx = 0; idx < LATENCY_HIST_BUCKETS - 1; idx++)
+	{
+		seen += hist->buckets[idx];
+		if (seen >= rank)
+			break;
+	}
+
+	if (idx < LATENCY_HIST_SUB_BUCKETS)
+		return Min(idx, hist->max);
+	else
+	{
+		int			shift = idx / (LATENCY_HIST_SUB_BUCKETS / 2) - 1;
+		int64		sub = idx - shift * (LATENCY_HIST_SUB_BUCKETS / 2);
+
+		return Min(((sub + 1) << shift) - 1, hist->max);
+	}
+}
+
 /*
  * Initialize a StatsData struct to mostly zeroes, with its start time set to
  * the given value.
@@ -4103,6 +4227,9 @@ advanceConnectionState(TState *thread, CState *st, StatsData *agg)
 					/* XXX could use a mutex here, but we choose not to */
 					addToSimpleStats(&command->stats,
 									 PG_TIME_GET_DOUBLE(now - st->stmt_begin));
+					if (thread->command_hist)
+						addToLatencyHistogram(&thread->command_hist[st->use_file][st->command],
+											  now - st->stmt_begin);
 				}
 
 				/* Go ahead with next command, to be executed or skipped */
@@ -4757,7 +4884,7 @@ processXactStats(TState *thread, CState *st, pg_time_usec_t *now,
 	double		latency = 0.0,
 				lag = 0.0;
 	bool		detailed = progress || throttle_delay || latency_limit ||
-		use_log || per_script_stats;
+		use_log || per_script_stats || report_percentiles;
 
 	if (detailed && !skipped && st->estatus == ESTATUS_NO_ERROR)
 	{
@@ -4770,6 +4897,8 @@ processXactStats(TState *thread, CState *st, pg_time_usec_t *now,
 
 	/* keep detailed thread stats */
 	accumStats(&thread->stats, skipped, latency, lag, st->estatus, st->tries);
+	if (thread->latency_hist && !skipped && st->estatus == ESTATUS_NO_ERROR)
+		addToLatencyHistogram(thread->latency_hist, latency);
 
 	/* count transactions over the latency limit, if needed */
 	if (latency_limit && latency > latency_limit)
@@ -4783,8 +4912,15 @@ processXactStats(TState *thread, CState *st, pg_time_usec_t *now,
 
 	/* XXX could use a mutex here, but we choose not to */
 	if (per_script_stats)
-		accumStats(&sql_script[st->use_file].stats, skipped, latency, lag,
+	{
+		ParsedScript *script = &sql_script[st->use_file];
+
+		accumStats(&script->stats, skipped, latency, lag,
 				   st->estatus, st->tries);
+		if (thread->script_hist && !skipped &&
+			st->estatus == ESTATUS_NO_ERROR)
+			addToLatencyHistogram(&thread->script_hist[st->use_file], latency);
+	}
 }
 
 
@@ -5672,6 +5808,7 @@ create_sql_command(PQExpBuffer buf)
 	my_command->varprefix = NULL;	/* allocated later, if needed */
 	my_command->expr = NULL;
 	initSimpleStats(&my_command->stats);
+	my_command->latency_hist = NULL;	/* set later, if needed */
 	my_command->prepname = NULL;	/* set later, if needed */
 
 	return my_command;
@@ -6417,6 +6554,18 @@ printSimpleStats(const char *prefix, SimpleStats *ss)
 	}
 }
 
+static void
+printLatencyPercentiles(const char *prefix, LatencyHistogram *hist)
+{
+	if (hist->count > 0)
+	{
+		for (int i = 0; i < lengthof(latency_percentiles); i++)
+			printf("%s %gth percentile = %.3f ms\n", prefix,
+				   latency_percentiles[i],
+				   0.001 * getLatencyPercentile(hist, latency_percentiles[i]));
+	}
+}
+
 /* print version banner */
 static void
 printVersion(PGconn *con)
@@ -6454,7 +6603,8 @@ printResults(StatsData *total,
 			 pg_time_usec_t total_duration, /* benchmarking time */
 			 pg_time_usec_t conn_total_duration,	/* is_connect */
 			 pg_time_usec_t conn_elapsed_duration,	/* !is_connect */
-			 int64 latency_late)
+			 int64 latency_late,
+			 LatencyHistogram *latency_hist)	/* report_percentiles */
 {
 	/* tps is about actually executed transactions during benchmarking */
 	int64		failures = getFailures(total);
@@ -6531,7 +6681,7 @@ printResults(StatsData *total,
 			   latency_limit / 1000.0, latency_late, total->cnt,
 			   (total->cnt > 0) ? 100.0 * latency_late / total->cnt : 0.0);
 
-	if (throttle_delay || progress || latency_limit)
+	if (throttle_delay || progress || latency_limit || report_percentiles)
 		printSimpleStats("latency", &total->latency);
 	else
 	{
@@ -6553,6 +6703,9 @@ printResults(StatsData *total,
 			   0.001 * total->lag.sum / total->cnt, 0.001 * total->lag.max);
 	}
 
+	if (latency_hist)
+		printLatencyPercentiles("latency", latency_hist);
+
 	/*
 	 * Under -C/--connect, each transaction incurs a significant connection
 	 * cost, it would not make much sense to ignore it in tps, and it would
@@ -6641,6 +6794,9 @@ printResults(StatsData *total,
 
 				}
 				printSimpleStats(" - latency", &sstats->latency);
+				if (sql_script[i].latency_hist)
+					printLatencyPercentiles(" - latency",
+											sql_script[i].latency_hist);
 			}
 
 			/*
@@ -6651,8 +6807,11 @@ printResults(StatsData *total,
 			{
 				Command   **commands;
 
-				printf("%sstatement latencies in milliseconds%s:\n",
+				printf("%sstatement latencies in milliseconds%s%s:\n",
 					   per_script_stats ? " - " : "",
+					   (report_percentiles ?
+						" (average, 50th, 90th, 99th and 99.9th percentiles)" :
+						""),
 					   (max_tries == 1 ?
 						" and failures" :
 						", failures and retries"));
@@ -6662,20 +6821,22 @@ printResults(StatsData *total,
 					 commands++)
 				{
 					SimpleStats *cstats = &(*commands)->stats;
+					LatencyHistogram *chist = (*commands)->latency_hist;
 
-					if (max_tries == 1)
-						printf("   %11.3f  %10" PRId64 " %s\n",
-							   (cstats->count > 0) ?
-							   1000.0 * cstats->sum / cstats->count : 0.0,
-							   (*commands)->failures,
-							   (*commands)->first_line);
-					else
-						printf("   %11.3f  %10" PRId64 " %10" PRId64 " %s\n",
-							   (cstats->count > 0) ?
-							   1000.0 * cstats->sum / cstats->count : 0.0,
-							   (*commands)->failures,
-							   (*commands)->retries,
-							   (*commands)->first_line);
+					printf("   %11.3f",
+						   (cstats->count > 0) ?
+						   1000.0 * cstats->sum / cstats->count : 0.0);
+					if (chist)
+					{
+						for (int j = 0; j < lengthof(latency_percentiles); j++)
+							printf(" %11.3f",
+								   0.001 * getLatencyPercentile(chist,
+																latency_percentiles[j]));
+					}
+					printf("  %10" PRId64, (*commands)->failures);
+					if (max_tries != 1)
+						printf(" %10" PRId64, (*commands)->retries);
+					printf(" %s\n", (*commands)->first_line);
 				}
 			}
 		}
@@ -6779,6 +6940,7 @@ main(int argc, char **argv)
 		{"exit-on-abort", no_argument, NULL, 16},
 		{"debug", no_argument, NULL, 17},
 		{"continue-on-error", no_argument, NULL, 18},
+		{"report-percentiles", no_argument, NULL, 19},
 		{NULL, 0, NULL, 0}
 	};
 
@@ -6805,6 +6967,7 @@ main(int argc, char **argv)
 										 * threads */
 	int64		latency_late = 0;
 	StatsData	stats;
+	LatencyHistogram *latency_hist = NULL;
 	int			weight;
 
 	int			i;
@@ -7136,6 +7299,10 @@ main(int argc, char **argv)
 				benchmarking_option_set = true;
 				continue_on_error = true;
 				break;
+			case 19:			/* report-percentiles */
+				benchmarking_option_set = true;
+				report_percentiles = true;
+				break;
 			default:
 				/* getopt_long already emitted a complaint */
 				pg_log_error_hint("Try \"%s --help\" for more information.", progname);
@@ -7171,6 +7338,23 @@ main(int argc, char **argv)
 	if (num_scripts > 1)
 		per_script_stats = true;
 
+	/* set up latency histograms, if needed */
+	if (report_percentiles)
+	{
+		for (i = 0; i < num_scripts; i++)
+		{
+			if (per_script_stats)
+				sql_script[i].latency_hist = createLatencyHistogram();
+			if (report_per_command)
+			{
+				Command   **commands = sql_script[i].commands;
+
+				for (int j = 0; commands[j] != NULL; j++)
+					commands[j]->latency_hist = createLatencyHistogram();
+			}
+		}
+	}
+
 	/*
 	 * Don't need more threads than there are clients.  (This is not merely an
 	 * optimization; throttle_delay is calculated incorrectly below if some
@@ -7429,6 +7613,34 @@ main(int argc, char **argv)
 		thread->logfile = NULL; /* filled in later */
 		thread->latency_late = 0;
 		initStats(&thread->stats, 0);
+		thread->latency_hist = NULL;
+		thread->script_hist = NULL;
+		thread->command_hist = NULL;
+		if (report_percentiles)
+		{
+			/*
+			 * Each thread keeps histograms of its own, so that they need no
+			 * locking; they are merged once all threads are done.
+			 */
+			thread->latency_hist = createLatencyHistogram();
+			if (per_script_stats)
+				thread->script_hist =
+					pg_malloc0_array(LatencyHistogram, num_scripts);
+			if (report_per_command)
+			{
+				thread->command_hist =
+					pg_malloc_array(LatencyHistogram *, num_scripts);
+				for (int j = 0; j < num_scripts; j++)
+				{
+					int			ncommands = 0;
+
+					while (sql_script[j].commands[ncommands] != NULL)
+						ncommands++;
+					thread->command_hist[j] =
+						pg_malloc0_array(LatencyHistogram, ncommands);
+				}
+			}
+		}
 
 		nclients_dealt += thread->nstate;
 	}
@@ -7469,6 +7681,8 @@ main(int argc, char **argv)
 
 	/* wait for other threads and accumulate results */
 	initStats(&stats, 0);
+	if (report_percentiles)
+		latency_hist = createLatencyHistogram();
 	conn_total_duration = 0;
 
 	for (i = 0; i < nthreads; i++)
@@ -7485,6 +7699,22 @@ main(int argc, char **argv)
 		/* aggregate thread level stats */
 		mergeSimpleStats(&stats.latency, &thread->stats.latency);
 		mergeSimpleStats(&stats.lag, &thread->stats.lag);
+		if (latency_hist)
+			mergeLatencyHistogram(latency_hist, thread->latency_hist);
+		for (int j = 0; j < num_scripts; j++)
+		{
+			Command   **commands = sql_script[j].commands;
+
+			if (thread->script_hist)
+				mergeLatencyHistogram(sql_script[j].latency_hist,
+									  &thread->script_hist[j]);
+			if (thread->command_hist)
+			{
+				for (int k = 0; commands[k] != NULL; k++)
+					mergeLatencyHistogram(commands[k]->latency_hist,
+										  &thread->command_hist[j][k]);
+			}
+		}
 		stats.cnt += thread->stats.cnt;
 		stats.skipped += thread->stats.skipped;
 		stats.retries += thread->stats.retries;
@@ -7515,7 +7745,7 @@ main(int argc, char **argv)
 	 * underestimated.
 	 */
 	printResults(&stats, pg_time_now() - bench_start, conn_total_duration,
-				 bench_start - start_time, latency_late);
+				 bench_start - start_time, latency_late, latency_hist);
 
 	THREAD_BARRIER_DESTROY(&barrier);
 
@@ -1504,6 +1504,21 @@ $node->pgbench(
 	'pgbench late throttling',
 	{ '001_pgbench_sleep' => q{\sleep 2ms} });
 
+# latency percentiles, overall, per script and per command
+$node->pgbench(
+	'-t 20 -c 2 -n -r --report-percentiles -b se@1 -b se@1',
+	0,
+	[
+		qr{processed: 40/40},
+		qr{latency 50th percentile = \d+\.\d+ ms},
+		qr{latency 99\.9th percentile = \d+\.\d+ ms},
+		qr{ - latency 90th percentile = \d+\.\d+ ms},
+		qr{latencies in milliseconds \(average, 50th, 90th, 99th and 99\.9th percentiles\) and failures},
+		qr{(?:\s+\d+\.\d+){5}\s+0\s+SELECT abalance}
+	],
+	[qr{^$}],
+	'pgbench latency percentiles');
+
 # return a list of files from directory $dir matching regexpr $re
 # this works around glob portability and escaping issues
 sub list_files
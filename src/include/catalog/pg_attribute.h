@@ -111,9 +111,9 @@ CATALOG(pg_attribute,1249,AttributeRelationId) BKI_BOOTSTRAP BKI_ROWTYPE_OID(75,
 	 * attcompression sets the current compression method of the attribute.
 	 * Typically this is InvalidCompressionMethod ('\0') to specify use of the
 	 * current default setting (see default_toast_compression).  Otherwise,
-	 * 'p' selects pglz compression, while 'l' selects LZ4 compression.
-	 * However, this field is ignored whenever attstorage does not allow
-	 * compression.
+	 * 'p' selects pglz compression, 'l' selects LZ4 compression, and 'z'
+	 * selects zstd compression.  However, this field is ignored whenever
+	 * attstorage does not allow compression.
 	 */
 	char		attcompression BKI_DEFAULT('\0');
 
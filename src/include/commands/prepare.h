@@ -34,6 +34,9 @@ typedef struct
 	TimestampTz prepare_time;	/* the time when the stmt was prepared */
 } PreparedStatement;
 
+/* GUC parameter */
+extern PGDLLIMPORT int plan_cache_simple_queries;
+
 
 /* Utility statements PREPARE, EXECUTE, DEALLOCATE, EXPLAIN EXECUTE */
 extern void PrepareQuery(ParseState *pstate, PrepareStmt *stmt,
@@ -59,4 +62,12 @@ extern List *FetchPreparedStatementTargetList(PreparedStatement *stmt);
 
 extern void DropAllPreparedStatements(void);
 
+/* Plans cached for statements sent via the simple query protocol */
+extern bool SimpleQueryIsCacheable(RawStmt *parsetree);
+extern CachedPlanSource *GetSimpleQueryPlan(RawStmt *parsetree,
+											const char *query_string,
+											CommandTag commandTag,
+											ParamListInfo *params);
+extern void DropAllSimpleQueryPlans(void);
+
 #endif							/* PREPARE_H */
@@ -131,6 +131,8 @@ typedef struct PartitionPruneState
 } PartitionPruneState;
 
 extern void ExecDoInitialPruning(EState *estate);
+extern Bitmapset *ExecGetInitialUnprunedRelids(PlannedStmt *plannedstmt,
+											   ParamListInfo params);
 extern PartitionPruneState *ExecInitPartitionExecPruning(PlanState *planstate,
 														 int n_total_subplans,
 														 int part_prune_index,
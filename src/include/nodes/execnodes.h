@@ -1616,6 +1616,8 @@ typedef struct BitmapOrState
  *		currentRelation    relation being scanned (NULL if none)
  *		currentScanDesc    current scan descriptor for scan (NULL if none)
  *		ScanTupleSlot	   pointer to slot in tuple table holding scan tuple
+ *		feedback_*		   row counts kept for cardinality feedback, for scans
+ *						   that the planner tagged with a feedback key
  * ----------------
  */
 typedef struct ScanState
@@ -1624,6 +1626,11 @@ typedef struct ScanState
 	Relation	ss_currentRelation;
 	struct TableScanDescData *ss_currentScanDesc;
 	TupleTableSlot *ss_ScanTupleSlot;
+	double		ss_feedback_tuples; /* tuples returned in the current loop */
+	bool		ss_feedback_done;	/* current loop reached end of scan? */
+	double		ss_feedback_ntuples;	/* tuples returned in completed loops */
+	double		ss_feedback_nloops; /* number of completed loops */
+	bool		ss_feedback_mark;	/* may be restored to a mark? */
 } ScanState;
 
 /* ----------------
@@ -123,6 +123,13 @@ typedef struct PlannedStmt
 	/* integer list of RT indexes, or NIL */
 	List	   *resultRelations;
 
+	/*
+	 * rtable index of the first target relation of each ModifyTable node in
+	 * the plan; the executor keeps it even if initial pruning removes it
+	 */
+	/* integer list of RT indexes, or NIL */
+	List	   *firstResultRels;
+
 	/* list of AppendRelInfo nodes */
 	List	   *appendRelations;
 
@@ -521,6 +528,8 @@ typedef struct Scan
 	Plan		plan;
 	/* relid is index into the range table */
 	Index		scanrelid;
+	/* cardinality feedback key, or 0 (see optimizer/util/cardfeedback.c) */
+	uint64		feedback_key;
 } Scan;
 
 /* ----------------
@@ -0,0 +1,30 @@
+/*-------------------------------------------------------------------------
+ *
+ * cardfeedback.h
+ *	  prototypes for cardfeedback.c.
+ *
+ *
+ * Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+ * Portions Copyright (c) 1994, Regents of the University of California
+ *
+ * src/include/optimizer/cardfeedback.h
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef CARDFEEDBACK_H
+#define CARDFEEDBACK_H
+
+#include "nodes/pathnodes.h"
+
+/* GUC parameters */
+extern PGDLLIMPORT bool cardinality_feedback;
+extern PGDLLIMPORT int cardinality_feedback_max_entries;
+
+extern Size CardinalityFeedbackShmemSize(void);
+extern void CardinalityFeedbackShmemInit(void);
+
+extern uint64 cardinality_feedback_key(PlannerInfo *root, RelOptInfo *rel);
+extern bool cardinality_feedback_lookup(uint64 key, double *rows);
+extern void cardinality_feedback_record(uint64 key, double actual);
+
+#endif							/* CARDFEEDBACK_H */
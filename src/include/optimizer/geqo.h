@@ -71,6 +71,15 @@ extern PGDLLIMPORT int Geqo_planner_extension_id;
 
 extern PGDLLIMPORT double Geqo_seed;	/* 0 .. 1 */
 
+/* join order search strategy to use past geqo_threshold */
+typedef enum GeqoStrategy
+{
+	GEQO_STRATEGY_GENETIC,		/* genetic algorithm */
+	GEQO_STRATEGY_GREEDY,		/* greedy operator ordering */
+} GeqoStrategy;
+
+extern PGDLLIMPORT int Geqo_strategy;
+
 
 /*
  * Private state for a GEQO run --- accessible via GetGeqoPrivateData
@@ -97,4 +106,8 @@ extern RelOptInfo *geqo(PlannerInfo *root,
 extern Cost geqo_eval(PlannerInfo *root, Gene *tour, int num_gene);
 extern RelOptInfo *gimme_tree(PlannerInfo *root, Gene *tour, int num_gene);
 
+/* routines in geqo_greedy.c */
+extern RelOptInfo *geqo_greedy(PlannerInfo *root,
+							   int number_of_rels, List *initial_rels);
+
 #endif							/* GEQO_H */
@@ -119,6 +119,10 @@ extern Selectivity statext_clauselist_selectivity(PlannerInfo *root,
 												  RelOptInfo *rel,
 												  Bitmapset **estimatedclauses,
 												  bool is_or);
+extern Selectivity statext_join_clauselist_selectivity(PlannerInfo *root,
+													   List *clauses,
+													   JoinType jointype,
+													   Bitmapset **estimatedclauses);
 extern bool has_stats_of_kind(List *stats, char requiredkind);
 extern StatisticExtInfo *choose_best_statistics(List *stats, char requiredkind,
 												bool inh,
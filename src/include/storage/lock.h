@@ -524,7 +524,7 @@ typedef enum
  * NB: NUM_LOCK_PARTITIONS must be a power of 2!
  */
 #define LockHashPartition(hashcode) \
-	((hashcode) % NUM_LOCK_PARTITIONS)
+	((hashcode) & (NUM_LOCK_PARTITIONS - 1))
 #define LockHashPartitionLock(hashcode) \
 	(&MainLWLockArray[LOCK_MANAGER_LWLOCK_OFFSET + \
 		LockHashPartition(hashcode)].lock)
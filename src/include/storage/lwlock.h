@@ -90,22 +90,34 @@ extern PGDLLIMPORT int *LWLockCounter;
 /* Number of partitions of the shared buffer mapping hashtable */
 #define NUM_BUFFER_PARTITIONS  128
 
-/* Number of partitions the shared lock tables are divided into */
-#define LOG2_NUM_LOCK_PARTITIONS  4
-#define NUM_LOCK_PARTITIONS  (1 << LOG2_NUM_LOCK_PARTITIONS)
+/*
+ * Number of partitions the shared lock tables are divided into.  This is set
+ * at server start by lock_manager_partitions, which must be a power of 2 no
+ * larger than MAX_LOCK_PARTITIONS.
+ */
+#define LOG2_MAX_LOCK_PARTITIONS  8
+#define MAX_LOCK_PARTITIONS  (1 << LOG2_MAX_LOCK_PARTITIONS)
+#define DEFAULT_LOCK_PARTITIONS  16
+
+extern PGDLLIMPORT int lock_manager_partitions;
+
+#define NUM_LOCK_PARTITIONS  lock_manager_partitions
 
 /* Number of partitions the shared predicate lock tables are divided into */
 #define LOG2_NUM_PREDICATELOCK_PARTITIONS  4
 #define NUM_PREDICATELOCK_PARTITIONS  (1 << LOG2_NUM_PREDICATELOCK_PARTITIONS)
 
-/* Offsets for various chunks of preallocated lwlocks. */
+/*
+ * Offsets for various chunks of preallocated lwlocks.  The lock manager's
+ * chunk comes last, since its size is only known at server start.
+ */
 #define BUFFER_MAPPING_LWLOCK_OFFSET	NUM_INDIVIDUAL_LWLOCKS
-#define LOCK_MANAGER_LWLOCK_OFFSET		\
-	(BUFFER_MAPPING_LWLOCK_OFFSET + NUM_BUFFER_PARTITIONS)
 #define PREDICATELOCK_MANAGER_LWLOCK_OFFSET \
-	(LOCK_MANAGER_LWLOCK_OFFSET + NUM_LOCK_PARTITIONS)
-#define NUM_FIXED_LWLOCKS \
+	(BUFFER_MAPPING_LWLOCK_OFFSET + NUM_BUFFER_PARTITIONS)
+#define LOCK_MANAGER_LWLOCK_OFFSET		\
 	(PREDICATELOCK_MANAGER_LWLOCK_OFFSET + NUM_PREDICATELOCK_PARTITIONS)
+#define NUM_FIXED_LWLOCKS \
+	(LOCK_MANAGER_LWLOCK_OFFSET + NUM_LOCK_PARTITIONS)
 
 typedef enum LWLockMode
 {
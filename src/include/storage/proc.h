@@ -285,9 +285,10 @@ struct PGPROC
 	/*
 	 * All PROCLOCK objects for locks held or awaited by this backend are
 	 * linked into one of these lists, according to the partition number of
-	 * their lock.
+	 * their lock.  The array has NUM_LOCK_PARTITIONS entries, and is
+	 * allocated separately in shared memory, see InitProcGlobal().
 	 */
-	dlist_head	myProcLocks[NUM_LOCK_PARTITIONS];
+	dlist_head *myProcLocks;
 
 	XidCacheStatus subxidStatus;	/* mirrored with
 									 * ProcGlobal->subxidStates[i] */
@@ -199,6 +199,7 @@ extern CatCache *InitCatCache(int id, Oid reloid, Oid indexoid,
 							  int nkeys, const int *key,
 							  int nbuckets);
 extern void InitCatCachePhase2(CatCache *cache, bool touch_index);
+extern int	PreloadCatCache(CatCache *cache);
 
 extern HeapTuple SearchCatCache(CatCache *cache,
 								Datum v1, Datum v2, Datum v3, Datum v4);
@@ -38,6 +38,8 @@ extern bool check_backtrace_functions(char **newval, void **extra,
 extern void assign_backtrace_functions(const char *newval, void *extra);
 extern bool check_bonjour(bool *newval, void **extra, GucSource source);
 extern bool check_canonical_path(char **newval, void **extra, GucSource source);
+extern bool check_catalog_cache_preload(char **newval, void **extra,
+										GucSource source);
 extern void assign_checkpoint_completion_target(double newval, void *extra);
 extern bool check_client_connection_check_interval(int *newval, void **extra,
 												   GucSource source);
@@ -74,6 +76,8 @@ extern bool check_locale_numeric(char **newval, void **extra, GucSource source);
 extern void assign_locale_numeric(const char *newval, void *extra);
 extern bool check_locale_time(char **newval, void **extra, GucSource source);
 extern void assign_locale_time(const char *newval, void *extra);
+extern bool check_lock_manager_partitions(int *newval, void **extra,
+										  GucSource source);
 extern bool check_log_destination(char **newval, void **extra,
 								  GucSource source);
 extern void assign_log_destination(const char *newval, void *extra);
@@ -93,6 +97,7 @@ extern bool check_multixact_member_buffers(int *newval, void **extra,
 extern bool check_multixact_offset_buffers(int *newval, void **extra,
 										   GucSource source);
 extern bool check_notify_buffers(int *newval, void **extra, GucSource source);
+extern void assign_plan_cache_simple_queries(int newval, void *extra);
 extern bool check_primary_slot_name(char **newval, void **extra,
 									GucSource source);
 extern bool check_random_seed(double *newval, void **extra, GucSource source);
@@ -22,8 +22,12 @@
 
 #include "catalog/syscache_ids.h"	/* IWYU pragma: export */
 
+/* GUC parameter */
+extern PGDLLIMPORT char *catalog_cache_preload;
+
 extern void InitCatalogCache(void);
 extern void InitCatalogCachePhase2(void);
+extern void PreloadCatalogCaches(void);
 
 extern HeapTuple SearchSysCache(int cacheId,
 								Datum key1, Datum key2, Datum key3, Datum key4);
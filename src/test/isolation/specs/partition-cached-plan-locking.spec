@@ -0,0 +1,57 @@
+# Verify that executing a cached generic plan locks only the partitions that
+# survive initial pruning, and that concurrent DDL on the pruned ones is
+# handled correctly.
+
+setup
+{
+  CREATE TABLE gp_lock (a int) PARTITION BY LIST (a);
+  CREATE TABLE gp_lock1 PARTITION OF gp_lock FOR VALUES IN (1);
+  CREATE TABLE gp_lock2 PARTITION OF gp_lock FOR VALUES IN (2);
+  INSERT INTO gp_lock VALUES (1), (2);
+}
+
+teardown
+{
+  DROP TABLE gp_lock;
+}
+
+session s1
+setup
+{
+  SET plan_cache_mode = force_generic_plan;
+  PREPARE q(int) AS SELECT * FROM gp_lock WHERE a = $1;
+  PREPARE u(int) AS UPDATE gp_lock SET a = a WHERE a = $1;
+  EXECUTE q(1);
+  EXECUTE u(1);
+}
+step s1begin    { BEGIN; }
+step s1q1       { EXECUTE q(1); }
+step s1q2       { EXECUTE q(2); }
+step s1u2       { EXECUTE u(2); }
+step s1u3       { EXECUTE u(3); }
+step s1commit   { COMMIT; }
+
+session s2
+step s2begin    { BEGIN; }
+step s2lock1    { LOCK TABLE gp_lock1 IN ACCESS EXCLUSIVE MODE; }
+step s2lock2    { LOCK TABLE gp_lock2 IN ACCESS EXCLUSIVE MODE; }
+step s2index2   { CREATE INDEX gp_lock2_a ON gp_lock2 (a); }
+step s2drop2    { DROP TABLE gp_lock2; }
+step s2detach2  { ALTER TABLE gp_lock DETACH PARTITION gp_lock2; }
+step s2commit   { COMMIT; }
+
+# A pruned partition is not locked, so a lock held on it doesn't block
+# the query, but one held on a surviving partition does.
+permutation s2begin s2lock2 s1begin s1q1 s1q2 s2commit s1commit
+
+# DDL on a pruned partition that doesn't need a lock on the parent can go
+# ahead; the plan is then invalidated and rebuilt once the partition is
+# needed.
+permutation s1begin s1q1 s2index2 s1q2 s1commit
+
+# DDL that removes a partition must wait for the lock on the parent.
+permutation s1begin s1u2 s2drop2 s1commit
+permutation s1begin s1q1 s2detach2 s1commit
+
+# If all result relations are pruned, the first one is still locked.
+permutation s1begin s1u3 s2begin s2lock1 s1commit s2commit
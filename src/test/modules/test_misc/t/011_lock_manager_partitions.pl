@@ -0,0 +1,95 @@
+
+# Copyright (c) 2026, PostgreSQL Global Development Group
+
+# Check that the lock manager works with the smallest and the largest
+# number of lock partitions allowed by lock_manager_partitions, including
+# the code paths that take all partition locks at once.
+
+use strict;
+use warnings FATAL => 'all';
+use PostgreSQL::Test::Cluster;
+use PostgreSQL::Test::Utils;
+use Test::More;
+
+my $node = PostgreSQL::Test::Cluster->new('main');
+$node->init();
+$node->append_conf(
+	'postgresql.conf', qq(
+deadlock_timeout = 10ms
+max_locks_per_transaction = 256
+));
+$node->start;
+
+# Enough tables to overflow the fast-path lock slots of a backend.
+$node->safe_psql(
+	'postgres', q{
+DO $$
+BEGIN
+  FOR i IN 1..200 LOOP
+    EXECUTE format('CREATE TABLE lockpart_%s (a int)', i);
+  END LOOP;
+END
+$$;
+});
+
+foreach my $partitions (1, 256)
+{
+	$node->adjust_conf('postgresql.conf', 'lock_manager_partitions',
+		$partitions);
+	$node->restart;
+
+	is($node->safe_psql('postgres', 'SHOW lock_manager_partitions'),
+		$partitions, "lock_manager_partitions is $partitions");
+
+	# Take many locks in the main lock table, and read them back through
+	# pg_locks, which locks all partitions.
+	my $result = $node->safe_psql(
+		'postgres', q{
+BEGIN;
+DO $$
+BEGIN
+  FOR i IN 1..200 LOOP
+    EXECUTE format('LOCK TABLE lockpart_%s IN SHARE MODE', i);
+  END LOOP;
+END
+$$;
+SELECT count(*) FROM pg_locks
+  WHERE locktype = 'relation' AND mode = 'ShareLock'
+    AND pid = pg_backend_pid() AND granted;
+COMMIT;
+});
+	is($result, '200', "locks are reported with $partitions partitions");
+
+	# Run the deadlock detector, which also locks all partitions.
+	my $s1 = $node->background_psql('postgres', on_error_stop => 0);
+	my $s2 = $node->background_psql('postgres', on_error_stop => 0);
+
+	$s1->query_safe('BEGIN; LOCK TABLE lockpart_1;');
+	$s2->query_safe('BEGIN; LOCK TABLE lockpart_2;');
+	$s1->query_until(qr/lock_wait_started/, q(
+\echo lock_wait_started
+LOCK TABLE lockpart_2;
+));
+	$node->poll_query_until('postgres',
+		"SELECT count(*) = 1 FROM pg_locks WHERE NOT granted")
+	  or die "timed out waiting for lock wait";
+
+	$s2->query('LOCK TABLE lockpart_1;');
+	like($s2->{stderr}, qr/deadlock detected/,
+		"deadlock is detected with $partitions partitions");
+
+	# Ending the second session lets the first one get its lock.
+	$s2->quit;
+	$s1->quit;
+}
+
+# A value that is not a power of two is rejected.
+$node->stop;
+$node->adjust_conf('postgresql.conf', 'lock_manager_partitions', 3);
+my $log_offset = -s $node->logfile;
+ok(!$node->start(fail_ok => 1), 'server fails to start with 3 partitions');
+ok( $node->log_contains(
+		qr/"lock_manager_partitions" must be a power of two/, $log_offset),
+	'error is reported for 3 partitions');
+
+done_testing();
@@ -0,0 +1,68 @@
+-- Tests for TOAST compression with zstd
+
+SELECT NOT(enumvals @> '{zstd}') AS skip_test FROM pg_settings WHERE
+  name = 'default_toast_compression' \gset
+\if :skip_test
+   \echo '*** skipping TOAST tests with zstd (not supported) ***'
+   \quit
+\endif
+
+CREATE SCHEMA zstd;
+SET search_path TO zstd, public;
+
+-- Ensure we get stable results regardless of the installation's default.
+SET default_toast_compression = 'pglz';
+
+-- test creating table with compression method
+CREATE TABLE cmdata_zstd(f1 TEXT COMPRESSION zstd);
+INSERT INTO cmdata_zstd VALUES(repeat('1234567890', 1004));
+
+-- verify stored compression method in the data
+SELECT pg_column_compression(f1) FROM cmdata_zstd;
+
+-- decompress data slice
+SELECT SUBSTR(f1, 2000, 50) FROM cmdata_zstd;
+
+-- copy to existing table with a different compression method
+CREATE TABLE cmmove(f1 text COMPRESSION pglz);
+INSERT INTO cmmove SELECT * FROM cmdata_zstd;
+SELECT pg_column_compression(f1) FROM cmmove;
+
+-- test externally stored compressed data
+CREATE OR REPLACE FUNCTION large_val_zstd() RETURNS TEXT LANGUAGE SQL AS
+'select array_agg(fipshash(g::text))::text from generate_series(1, 256) g';
+CREATE TABLE cmdata2 (f1 text COMPRESSION zstd);
+INSERT INTO cmdata2 SELECT large_val_zstd() || repeat('a', 4000);
+SELECT pg_column_compression(f1) FROM cmdata2;
+SELECT SUBSTR(f1, 200, 5) FROM cmdata2;
+DROP TABLE cmdata2;
+DROP FUNCTION large_val_zstd;
+
+-- slices of a large value that compresses unevenly: the prefix is nearly
+-- incompressible and the tail highly compressible, so the amount of
+-- compressed data first fetched for a slice deep into the prefix is too
+-- small and has to be increased
+CREATE TABLE cmdata3 (f1 text COMPRESSION zstd);
+INSERT INTO cmdata3
+  SELECT string_agg(fipshash(g::text), '') || repeat('x', 4000000)
+  FROM generate_series(1, 16384) g;
+SELECT pg_column_compression(f1), length(f1) FROM cmdata3;
+SELECT o, SUBSTR(f1, o, 100) = SUBSTR(f1 || '', o, 100) AS ok
+  FROM cmdata3, (VALUES (1000), (900000), (1048500), (5048000)) v(o);
+DROP TABLE cmdata3;
+
+-- test default_toast_compression GUC
+SET default_toast_compression = 'zstd';
+CREATE TABLE cmdata_default(f1 text);
+INSERT INTO cmdata_default VALUES (repeat('123456789', 4004));
+SELECT pg_column_compression(f1) FROM cmdata_default;
+
+-- test alter compression method
+ALTER TABLE cmmove ALTER COLUMN f1 SET COMPRESSION zstd;
+INSERT INTO cmmove VALUES (repeat('123456789', 4004));
+SELECT pg_column_compression(f1) FROM cmmove;
+
+-- check data is ok
+SELECT length(f1) FROM cmdata_zstd;
+SELECT length(f1) FROM cmdata_default;
+SELECT length(f1) FROM cmmove;
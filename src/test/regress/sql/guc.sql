@@ -377,3 +377,20 @@ SELECT name FROM tab_settings_flags
   WHERE no_reset AND NOT no_reset_all
   ORDER BY 1;
 DROP TABLE tab_settings_flags;
+
+-- catalog_cache_preload is applied at session start, and cannot be changed
+-- afterwards
+CREATE DOMAIN preload_dom AS int;
+CREATE FUNCTION preload_func() RETURNS int LANGUAGE sql AS 'SELECT 1';
+\c -reuse-previous=on 'options=-ccatalog_cache_preload=pg_type,pg_proc'
+SHOW catalog_cache_preload;
+SELECT 'int4'::regtype, 'int4in'::regproc;
+SET catalog_cache_preload = 'pg_class';
+-- preloaded entries see later changes to the catalogs
+SELECT 'preload_dom'::regtype, preload_func();
+ALTER DOMAIN preload_dom RENAME TO preload_dom2;
+CREATE OR REPLACE FUNCTION preload_func() RETURNS int LANGUAGE sql AS 'SELECT 2';
+SELECT 'preload_dom2'::regtype, preload_func();
+SELECT 'preload_dom'::regtype;
+DROP DOMAIN preload_dom2;
+DROP FUNCTION preload_func();
@@ -386,6 +386,73 @@ select count(*) from tenk1 x where
   x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
 rollback;
 
+-- and with the greedy join search
+begin;
+set geqo = on;
+set geqo_threshold = 2;
+set geqo_strategy = greedy;
+select count(*) from tenk1 x where
+  x.unique1 in (select a.f1 from int4_tbl a,float8_tbl b where a.f1=b.f1) and
+  x.unique1 = 0 and
+  x.unique1 in (select aa.f1 from int4_tbl aa,float8_tbl bb where aa.f1=bb.f1);
+rollback;
+
+-- check that the greedy join search does the smallest join first
+begin;
+set geqo = on;
+set geqo_threshold = 2;
+set geqo_strategy = greedy;
+create temp table gr_big (a int);
+insert into gr_big select i from generate_series(1, 1000) i;
+create temp table gr_mid (a int, c int);
+insert into gr_mid select i * 10, i from generate_series(1, 100) i;
+create temp table gr_small (c int);
+insert into gr_small select i from generate_series(1, 10) i;
+analyze gr_big, gr_mid, gr_small;
+-- show the join tree of a plan, ignoring which input is outer and inner
+create function greedy_join_tree(node json) returns text
+language plpgsql as
+$$
+declare
+  l text collate "C";
+  r text collate "C";
+begin
+  if node->>'Node Type' in ('Nested Loop', 'Hash Join', 'Merge Join') then
+    l := greedy_join_tree(node->'Plans'->0);
+    r := greedy_join_tree(node->'Plans'->1);
+    return '(' || least(l, r) || ' ' || greatest(l, r) || ')';
+  elsif node->'Plans' is not null then
+    return greedy_join_tree(node->'Plans'->0);
+  end if;
+  return node->>'Alias';
+end
+$$;
+create function greedy_join_order(query text) returns text
+language plpgsql as
+$$
+declare
+  plan json;
+begin
+  execute 'explain (costs off, format json) ' || query into plan;
+  return greedy_join_tree(plan->0->'Plan');
+end
+$$;
+select greedy_join_order($$
+  select * from gr_big b join gr_mid m on b.a = m.a join gr_small s on m.c = s.c
+$$);
+-- here the greedy choices (q w) and then (x z) leave two clumps that have
+-- lateral references to each other, so the genetic search must take over
+create temp table gr_x (a int);
+insert into gr_x select i from generate_series(1, 5) i;
+create temp table gr_q (a int);
+insert into gr_q select i % 50 + 1 from generate_series(1, 100) i;
+analyze gr_x, gr_q;
+select count(*) from gr_x x, gr_q q,
+  lateral (select q.a from generate_series(1, 10) offset 0) z,
+  lateral (select x.a offset 0) w
+  where x.a = z.a and q.a = w.a;
+rollback;
+
 --
 -- regression test: be sure we cope with proven-dummy append rels
 --
@@ -1447,3 +1447,51 @@ select min(a) over (partition by a order by a) from part_abc where a >= stable_o
 
 drop view part_abc_view;
 drop table part_abc;
+
+-- Check that executing a cached generic plan locks only the partitions
+-- that survive initial pruning
+create table lp_gp (a int) partition by list (a);
+create table lp_gp1 partition of lp_gp for values in (1);
+create table lp_gp2 partition of lp_gp for values in (2);
+set plan_cache_mode = force_generic_plan;
+prepare lp_gp_q (int) as select * from lp_gp where a = $1;
+execute lp_gp_q (1);
+begin;
+execute lp_gp_q (1);
+select relation::regclass from pg_locks
+  where locktype = 'relation' and pid = pg_backend_pid() and
+        relation::regclass::text like 'lp_gp%'
+  order by 1;
+commit;
+-- The same for UPDATE and DELETE.  If all result relations are pruned,
+-- the first one is kept, so it must be locked too.
+prepare lp_gp_u (int) as update lp_gp set a = a where a = $1;
+prepare lp_gp_d (int) as delete from lp_gp where a = $1;
+execute lp_gp_u (1);
+execute lp_gp_d (1);
+begin;
+execute lp_gp_u (2);
+select relation::regclass, mode from pg_locks
+  where locktype = 'relation' and pid = pg_backend_pid() and
+        relation::regclass::text like 'lp_gp%'
+  order by 1, 2;
+rollback;
+begin;
+execute lp_gp_u (3);
+select relation::regclass, mode from pg_locks
+  where locktype = 'relation' and pid = pg_backend_pid() and
+        relation::regclass::text like 'lp_gp%'
+  order by 1, 2;
+rollback;
+begin;
+execute lp_gp_d (2);
+select relation::regclass, mode from pg_locks
+  where locktype = 'relation' and pid = pg_backend_pid() and
+        relation::regclass::text like 'lp_gp%'
+  order by 1, 2;
+rollback;
+deallocate lp_gp_u;
+deallocate lp_gp_d;
+deallocate lp_gp_q;
+reset plan_cache_mode;
+drop table lp_gp;
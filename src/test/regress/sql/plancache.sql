@@ -223,3 +223,65 @@ select name, generic_plans, custom_plans from pg_prepared_statements
   where  name = 'test_mode_pp';
 
 drop table test_mode;
+
+-- plans cached for queries sent via the simple query protocol
+-- (the checks use \bind, so they are not cached themselves)
+create function simple_pc_plans(prefix text, out sources bigint, out plans bigint)
+language sql as $$
+  select count(*) filter (where name = 'CachedPlanSource'),
+         count(*) filter (where name = 'CachedPlan')
+  from pg_backend_memory_contexts where ident like prefix || '%'
+$$;
+set plan_cache_simple_queries = 2;
+create temp table simple_pc (a int);
+insert into simple_pc values (1);
+select * from simple_pc;
+select * from simple_pc;
+select sources, plans from simple_pc_plans($1) \bind 'select * from simple_pc' \g
+-- the cached plan must follow a change of the result type
+alter table simple_pc add column b text default 'x';
+select * from simple_pc;
+-- evict the entry, then make it again
+select 1 as one;
+select 1 as one, 2 as two;
+select sources, plans from simple_pc_plans($1) \bind 'select * from simple_pc' \g
+select * from simple_pc;
+select sources, plans from simple_pc_plans($1) \bind 'select * from simple_pc' \g
+-- statements that differ only in their constants share a plan
+insert into simple_pc values (2), (3);
+select a from simple_pc where a = 1;
+select a from simple_pc where a = 2;
+select sources, plans from simple_pc_plans($1) \bind 'select a from simple_pc where' \g
+set plan_cache_mode = force_generic_plan;
+select a from simple_pc where a = 3;
+select a from simple_pc where a = 1;
+select sources, plans from simple_pc_plans($1) \bind 'select a from simple_pc where' \g
+-- equal constants must stay matched up with each other
+select a + 1 as c, count(*) from simple_pc group by a + 1 having a + 1 > 2 order by 1;
+select a + 2 as c, count(*) from simple_pc group by a + 2 having a + 2 > 2 order by 1;
+-- column positions must not become parameters
+select a, -a as c from simple_pc order by 1;
+select a, -a as c from simple_pc order by 2;
+-- the least recently used entry is evicted, not the oldest one
+select a from simple_pc where a = 1;
+select a, -a as c from simple_pc order by 2;
+select count(*) from simple_pc;
+select sources, plans from simple_pc_plans($1) \bind 'select a from simple_pc where' \g
+select sources, plans from simple_pc_plans($1) \bind 'select a, -a as c' \g
+reset plan_cache_mode;
+-- literals converted according to the current time are not frozen
+create temp table simple_pc_now (t timestamptz);
+set compute_query_id = off;
+insert into simple_pc_now values ('now');
+select pg_sleep(0.01);
+insert into simple_pc_now values ('now');
+select sources, plans from simple_pc_plans($1) \bind 'insert into simple_pc_now' \g
+reset compute_query_id;
+select pg_sleep(0.01);
+insert into simple_pc_now values ('now');
+select pg_sleep(0.01);
+insert into simple_pc_now values ('now');
+select count(distinct t) from simple_pc_now;
+reset plan_cache_simple_queries;
+drop table simple_pc, simple_pc_now;
+drop function simple_pc_plans;
@@ -583,6 +583,68 @@ SELECT * FROM check_estimated_rows('SELECT COUNT(*) FROM ndistinct GROUP BY a, (
 DROP STATISTICS s11;
 DROP STATISTICS s12;
 
+-- ndistinct statistics applied to joins on several columns
+CREATE TABLE ndistinct_join1 (a INT, b INT) WITH (autovacuum_enabled = off);
+CREATE TABLE ndistinct_join2 (a INT, b INT) WITH (autovacuum_enabled = off);
+
+INSERT INTO ndistinct_join1 SELECT i % 10, i % 10 FROM generate_series(1, 1000) s(i);
+INSERT INTO ndistinct_join2 SELECT i % 10, i % 10 FROM generate_series(1, 1000) s(i);
+
+ANALYZE ndistinct_join1, ndistinct_join2;
+
+-- without statistics, the clauses are assumed independent
+SELECT * FROM check_estimated_rows('SELECT * FROM ndistinct_join1 j1 JOIN ndistinct_join2 j2 ON (j1.a = j2.a AND j1.b = j2.b)');
+
+-- statistics on one side only are not enough
+CREATE STATISTICS s_join1 (ndistinct) ON a, b FROM ndistinct_join1;
+ANALYZE ndistinct_join1;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM ndistinct_join1 j1 JOIN ndistinct_join2 j2 ON (j1.a = j2.a AND j1.b = j2.b)');
+
+CREATE STATISTICS s_join2 (ndistinct) ON a, b FROM ndistinct_join2;
+ANALYZE ndistinct_join2;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM ndistinct_join1 j1 JOIN ndistinct_join2 j2 ON (j1.a = j2.a AND j1.b = j2.b)');
+
+SELECT * FROM check_estimated_rows('SELECT * FROM ndistinct_join1 j1 LEFT JOIN ndistinct_join2 j2 ON (j1.a = j2.a AND j1.b = j2.b)');
+
+-- the number of distinct combinations is clamped to the restricted row count
+CREATE TABLE ndistinct_join3 (a INT, b INT, c INT) WITH (autovacuum_enabled = off);
+INSERT INTO ndistinct_join3 SELECT i, i, i FROM generate_series(1, 1000) s(i);
+CREATE STATISTICS s_join3 (ndistinct) ON a, b FROM ndistinct_join3;
+ANALYZE ndistinct_join3;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM ndistinct_join3 j3 JOIN ndistinct_join2 j2 ON (j3.a = j2.a AND j3.b = j2.b) WHERE j3.c = 5');
+
+DROP TABLE ndistinct_join1, ndistinct_join2, ndistinct_join3;
+
+-- cardinality feedback corrects the estimates of correlated clauses
+CREATE TABLE card_feedback (a INT, b INT) WITH (autovacuum_enabled = off);
+
+INSERT INTO card_feedback SELECT i % 100, i % 100 FROM generate_series(1, 10000) s(i);
+
+ANALYZE card_feedback;
+
+SET cardinality_feedback = on;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM card_feedback WHERE a = 1 AND b = 1');
+
+SELECT * FROM check_estimated_rows('SELECT * FROM card_feedback WHERE a = 1 AND b = 1');
+
+-- different clauses are not affected
+SELECT * FROM check_estimated_rows('SELECT * FROM card_feedback WHERE a = 2 AND b = 2');
+
+-- scans stopped early are not recorded
+SELECT * FROM card_feedback WHERE a = 3 AND b = 3 LIMIT 1;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM card_feedback WHERE a = 3 AND b = 3');
+
+RESET cardinality_feedback;
+
+SELECT * FROM check_estimated_rows('SELECT * FROM card_feedback WHERE a = 1 AND b = 1');
+
+DROP TABLE card_feedback;
+
 -- functional dependencies tests
 CREATE TABLE functional_dependencies (
     filler1 TEXT,
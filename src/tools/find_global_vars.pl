@@ -0,0 +1,128 @@
+#!/usr/bin/perl
+
+#----------------------------------------------------------------------
+#
+# find_global_vars.pl
+#	Perl script that lists the writable global and static variables
+#	defined in a set of compiled object files.
+#
+# Every such variable is per-backend state today, because each backend is
+# a separate process.  Running backends as threads requires each of them
+# to be either made thread-local, moved into a per-session structure, or
+# shown to be safe to share (for example, because it is only set in the
+# postmaster before any backend is launched).  This script produces the
+# inventory to work from.
+#
+# Variables that back a GUC, according to guc_parameters.dat, are flagged
+# as such, since those will be handled wholesale by the GUC machinery
+# rather than one by one.
+#
+# Run it on a compiled tree, passing object files or directories to scan,
+# for example:
+#
+#	src/tools/find_global_vars.pl src/backend
+#
+# The output is one line per variable, tab-separated: object file,
+# variable name, linkage ("extern", "static" or "local" for function-level
+# statics), section ("data" or "bss"), and "guc" if the variable is a GUC.
+# A summary is printed to stderr.
+#
+# Portions Copyright (c) 1996-2026, PostgreSQL Global Development Group
+# Portions Copyright (c) 1994, Regents of the University of California
+#
+# src/tools/find_global_vars.pl
+#
+#----------------------------------------------------------------------
+
+use strict;
+use warnings FATAL => 'all';
+
+use File::Find;
+use FindBin;
+use Getopt::Long;
+
+my $guc_file = "$FindBin::RealBin/../backend/utils/misc/guc_parameters.dat";
+my $nm = $ENV{NM} || 'nm';
+
+GetOptions('guc-file=s' => \$guc_file)
+  or die "Usage: $0 [--guc-file=FILE] object-or-directory ...\n";
+die "Usage: $0 [--guc-file=FILE] object-or-directory ...\n" unless @ARGV;
+
+# Collect the names of variables backing GUCs.
+my %guc_vars;
+if (-f $guc_file)
+{
+	open(my $gfh, '<', $guc_file) || die "$guc_file: $!";
+	while (my $line = <$gfh>)
+	{
+		$guc_vars{$1} = 1 if $line =~ /\bvariable\s*=>\s*'(\w+)'/;
+	}
+	close($gfh);
+}
+else
+{
+	warn "$guc_file not found, GUC variables will not be flagged\n";
+}
+
+# Expand directories into the object files they contain.
+my @objects;
+for my $arg (@ARGV)
+{
+	if (-d $arg)
+	{
+		find(
+			sub {
+				push @objects, $File::Find::name
+				  if -f $_ && /\.o$/;
+			},
+			$arg);
+	}
+	else
+	{
+		push @objects, $arg;
+	}
+}
+
+my %count = (extern => 0, static => 0, local => 0, guc => 0);
+
+for my $object (sort @objects)
+{
+	open(my $nfh, '-|', $nm, $object) || die "could not run $nm: $!";
+	while (my $line = <$nfh>)
+	{
+		# Defined symbols look like "<address> <type> <name>".  We want
+		# initialized (d/D) and uninitialized (b/B) data; read-only data
+		# (r/R) is safe to share and is skipped.  With -fcommon,
+		# uninitialized globals are common symbols (C) instead of b/B.
+		next unless $line =~ /^[0-9a-fA-F]+\s+([bBCdD])\s+(\S+)$/;
+		my ($type, $name) = ($1, $2);
+		my $section = ($type =~ /^[bBC]$/) ? 'bss' : 'data';
+		my $linkage = ($type eq uc($type)) ? 'extern' : 'static';
+
+		# Function-level statics get a compiler-generated suffix.
+		if ($name =~ /^([A-Za-z_]\w*)\.\d+$/)
+		{
+			$name = $1;
+			$linkage = 'local';
+		}
+
+		# Skip compiler-generated symbols with no C-level counterpart.
+		next unless $name =~ /^[A-Za-z_]\w*$/;
+
+		my $is_guc = $linkage ne 'local' && exists $guc_vars{$name};
+
+		print join("\t",
+			$object, $name, $linkage, $section, $is_guc ? 'guc' : ''),
+		  "\n";
+
+		$count{$linkage}++;
+		$count{guc}++ if $is_guc;
+	}
+	close($nfh)
+	  or die "$nm failed on $object: "
+	  . ($! ? "$!" : "exit status " . ($? >> 8)) . "\n";
+}
+
+printf STDERR
+  "%d extern, %d static, %d function-level static variables; %d back a GUC\n",
+  $count{extern}, $count{static}, $count{local}, $count{guc};